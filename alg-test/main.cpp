@@ -1,5 +1,16 @@
 #include "include/calculator.hpp"
+#include "include/bdd.hpp"
+#include "include/cnf.hpp"
+#include "include/dnf_view.hpp"
+#include "include/counter.hpp"
+#include "include/minimizer.hpp"
+#include "include/solver.hpp"
+#include "include/evaluator.hpp"
+#include "include/enumerator.hpp"
+#include "include/expression.hpp"
 #include <iostream>
+#include <thread>
+#include <unordered_set>
 #include <sstream>
 #include <assert.h>
 
@@ -11,9 +22,9 @@ void test_invert(
 
     std::stringstream l_ss;
 
-    invert l_invert_0(operand::ptr(new unresolved("test")));
+    operand::ptr l_invert_0(new invert(operand::ptr(new unresolved("test"))));
 
-    l_ss << l_invert_0.to_string();
+    l_ss << l_invert_0->to_string();
     
     assert(l_ss.str() == "!test");
 
@@ -21,7 +32,7 @@ void test_invert(
     l_ss.str("");
 
 
-    operand::ptr l_sub_0 = l_invert_0.substitute("t", operand::ptr(new resolved(0)));
+    operand::ptr l_sub_0 = l_invert_0->substitute("t", operand::ptr(new resolved(0)));
 
     l_ss << l_sub_0->to_string();
 
@@ -31,7 +42,7 @@ void test_invert(
     l_ss.str("");
 
 
-    operand::ptr l_sub_1 = l_invert_0.substitute("test", operand::ptr(new resolved(0)));
+    operand::ptr l_sub_1 = l_invert_0->substitute("test", operand::ptr(new resolved(0)));
 
     l_ss << l_sub_1->to_string();
 
@@ -41,7 +52,7 @@ void test_invert(
     l_ss.str("");
 
 
-    operand::ptr l_simp_0 = l_invert_0.simplify();
+    operand::ptr l_simp_0 = l_invert_0->simplify();
 
     l_ss << l_simp_0->to_string();
     
@@ -62,11 +73,1642 @@ void test_invert(
 
 }
 
+void test_unique_table(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a_0(new unresolved("a"));
+    operand::ptr l_a_1(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+
+    // Structurally equal operands share a single canonical instance.
+    assert(l_a_0.get() == l_a_1.get());
+    assert(l_a_0.get() != l_b.get());
+
+    operand::ptr l_product_0(new product({l_a_0, operand::ptr(new invert(l_b))}));
+    operand::ptr l_product_1(new product({operand::ptr(new invert(l_b)), l_a_1}));
+
+    assert(l_product_0.get() == l_product_1.get());
+    assert(*l_product_0 == *l_product_1);
+
+    // a && (a || b) reduces to a, and so does (a && b) || (a && !b) || a.
+    operand::ptr l_reduced_0 = operand::ptr(new product({
+        l_a_0,
+        operand::ptr(new sum({l_a_0, l_b}))
+    }))->reduce();
+
+    operand::ptr l_reduced_1 = operand::ptr(new sum({
+        operand::ptr(new product({l_a_0, l_b})),
+        l_product_0,
+        l_a_0
+    }))->reduce();
+
+    assert(l_reduced_0.get() == l_reduced_1.get());
+
+    // Once the last reference is gone, the table forgets the operand.
+    std::size_t l_size = unique_table::size();
+
+    {
+        operand::ptr l_c(new unresolved("c"));
+        assert(unique_table::size() == l_size + 1);
+    }
+
+    assert(unique_table::size() == l_size);
+
+}
+
+void test_arena(
+
+)
+{
+    using namespace ba_calculator;
+
+    assert(arena::current() == nullptr);
+
+    operand::ptr l_escaped(nullptr);
+
+    std::size_t l_cache_size = reduce_cache::size();
+
+    {
+        arena::scope l_scope;
+
+        assert(arena::current() == l_scope.m_arena);
+
+        operand::ptr l_x(new unresolved("arena_x"));
+        operand::ptr l_y(new unresolved("arena_y"));
+
+        // Duplicates discarded by the unique table are handed back to the slab.
+        std::size_t l_offset = l_scope.m_arena->m_offset;
+        operand::ptr l_x_duplicate(new unresolved("arena_x"));
+        assert(l_scope.m_arena->m_offset == l_offset);
+
+        l_escaped = operand::ptr(new invert(
+            operand::ptr(new product({l_x, l_y}))
+        ))->reduce();
+
+        assert(l_scope.m_arena->m_live_allocations > 0);
+
+        // Jobs allocate from the arena of the thread which forked them.
+        std::atomic<std::size_t> l_adopted = 0;
+
+        std::vector<std::function<void()>> l_jobs(
+            8,
+            [&l_adopted, &l_scope]()
+            {
+                if (arena::current() == l_scope.m_arena)
+                    l_adopted++;
+            }
+        );
+
+        scheduler::run(l_jobs);
+        assert(l_adopted == l_jobs.size());
+        
+    }
+
+    assert(arena::current() == nullptr);
+
+    // The reductions cached under the scope were dropped along with it.
+    assert(reduce_cache::size() == l_cache_size);
+
+    // The result outlives the scope, and keeps its slabs alive until released.
+    assert(l_escaped->to_string() == "((!arena_x && ) || (!arena_y && ) || )");
+
+}
+
+void test_cube(
+
+)
+{
+    using namespace ba_calculator;
+
+    // Span more than one word of variables.
+    cube l_cube_0(130);
+    cube l_cube_1(130);
+
+    l_cube_0.insert(3, true);
+    l_cube_0.insert(129, false);
+
+    l_cube_1.insert(3, true);
+    l_cube_1.insert(70, true);
+    l_cube_1.insert(129, false);
+
+    assert(l_cube_0.literal_count() == 2);
+    assert(l_cube_1.literal_count() == 3);
+    assert(l_cube_0.covers(l_cube_1));
+    assert(!l_cube_1.covers(l_cube_0));
+
+    // Opposite polarity of the same variable does not cover.
+    cube l_cube_2(130);
+    l_cube_2.insert(3, false);
+    assert(!l_cube_2.covers(l_cube_1));
+
+    // (a && b) || (a && b && c) || (b && !c) reduces to (a && b) || (b && !c).
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+
+    operand::ptr l_reduced = operand::ptr(new sum({
+        operand::ptr(new product({l_a, l_b})),
+        operand::ptr(new product({l_a, l_b, l_c})),
+        operand::ptr(new product({l_b, operand::ptr(new invert(l_c))}))
+    }))->reduce();
+
+    assert(l_reduced->to_string() == "((a && b && ) || (b && !c && ) || )");
+
+}
+
+void test_sorted_vector(
+
+)
+{
+    using namespace ba_calculator;
+
+    // Duplicates are dropped, and the elements come out in ascending order.
+    sorted_vector<int, 4> l_inline({ 3, 1, 2, 3, 1 });
+
+    assert(l_inline.size() == 3);
+    assert(std::is_sorted(l_inline.begin(), l_inline.end()));
+    assert(l_inline.count(2) == 1 && l_inline.count(4) == 0);
+
+    // Past the inline capacity, elements spill into storage of their own.
+    std::vector<int> l_elements;
+
+    for (int i = 0; i < 100; i++)
+        l_elements.push_back((i * 37) % 100);
+
+    sorted_vector<int, 4> l_spilled(l_elements);
+    sorted_vector<int, 4> l_moved(std::move(l_spilled));
+
+    assert(l_moved.size() == 100);
+    assert(l_moved[0] == 0 && l_moved[99] == 99);
+    assert(*l_moved.rbegin() == 99);
+
+    // Operands keep their children in the same order as before.
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_not_a(new invert(l_a));
+
+    operand::ptr l_product(new product({l_not_a, l_b, l_a, l_b}));
+    const product& l_children = (const product&)*l_product;
+
+    assert(l_children.m_operands.size() == 3);
+    assert(l_children.m_operands[0].get() == l_a.get());
+    assert(l_children.m_operands[2].get() == l_not_a.get());
+    assert(l_product.get() == operand::ptr(new product(std::set<operand::ptr>({l_a, l_b, l_not_a}))).get());
+
+}
+
+void test_cube_trie(
+
+)
+{
+    using namespace ba_calculator;
+
+    cube_trie l_trie;
+
+    // Span more than one word of variables.
+    cube l_cube_0(130);
+    l_cube_0.insert(3, true);
+    l_cube_0.insert(129, false);
+
+    cube l_cube_1(130);
+    l_cube_1.insert(3, false);
+    l_cube_1.insert(70, true);
+
+    l_trie.insert(l_cube_0);
+    l_trie.insert(l_cube_1);
+    l_trie.insert(l_cube_0);
+
+    assert(l_trie.size() == 2);
+
+    // A superset of an indexed cube is covered, whichever branch it follows.
+    cube l_query_0 = l_cube_0;
+    l_query_0.insert(70, true);
+    assert(l_trie.covers(l_query_0));
+
+    cube l_query_1 = l_cube_1;
+    l_query_1.insert(129, true);
+    assert(l_trie.covers(l_query_1));
+
+    // Sharing a prefix, or holding a variable in the opposite polarity, is not enough.
+    cube l_query_2(130);
+    l_query_2.insert(3, true);
+    l_query_2.insert(70, true);
+    l_query_2.insert(129, true);
+    assert(!l_trie.covers(l_query_2));
+
+    // The empty cube covers everything.
+    l_trie.insert(cube(130));
+    assert(l_trie.covers(l_query_2));
+    assert(l_trie.covers(cube(130)));
+
+}
+
+void test_merge_opposites(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+    operand::ptr l_not_a(new invert(l_a));
+    operand::ptr l_not_b(new invert(l_b));
+    operand::ptr l_not_c(new invert(l_c));
+
+    // (a && b && c) || (a && b && !c) || (a && !b) merges into a && b, and then into a.
+    operand::ptr l_chained = operand::ptr(new sum({
+        operand::ptr(new product({l_a, l_b, l_c})),
+        operand::ptr(new product({l_a, l_b, l_not_c})),
+        operand::ptr(new product({l_a, l_not_b}))
+    }))->reduce();
+
+    assert(l_chained->to_string() == "((a && ) || )");
+
+    // Every minterm over a, b and c merges all the way down to 1.
+    std::set<operand::ptr> l_minterms;
+
+    for (std::size_t i = 0; i < 8; i++)
+        l_minterms.insert(operand::ptr(new product({
+            (i & 1) ? l_a : l_not_a,
+            (i & 2) ? l_b : l_not_b,
+            (i & 4) ? l_c : l_not_c
+        })));
+
+    assert(operand::ptr(new sum(l_minterms))->reduce()->to_string() == "1");
+
+    // Products which differ in more than one variable are left alone.
+    operand::ptr l_xor = operand::ptr(new sum({
+        operand::ptr(new product({l_a, l_not_b})),
+        operand::ptr(new product({l_not_a, l_b}))
+    }))->reduce();
+
+    assert(((const sum&)*l_xor).m_operands.size() == 2);
+
+    // Contradictory products are 0, and never merge with their neighbours.
+    operand::ptr l_xor_distributed = operand::ptr(new product({
+        operand::ptr(new sum({l_a, l_b})),
+        operand::ptr(new sum({l_not_a, l_not_b}))
+    }))->reduce();
+
+    assert(l_xor_distributed.get() == l_xor.get());
+
+    operand::ptr l_contradiction = operand::ptr(new product({
+        l_a,
+        l_not_a,
+        operand::ptr(new sum({l_b, l_c})),
+        operand::ptr(new sum({l_not_b, l_c}))
+    }))->reduce();
+
+    assert(l_contradiction->to_string() == "0");
+
+    // Contradictions reduce to the same 0 whether flat or nested, with or
+    // without anything left to distribute over.
+    operand::ptr l_zero = operand::ptr(new resolved(0));
+
+    for (const operand::ptr& l_operand : {
+        operand::ptr(new product({l_a, l_not_a})),
+        operand::ptr(new product({l_a, operand::ptr(new product({l_not_a}))})),
+        operand::ptr(new product({l_a, operand::ptr(new product({l_not_a, l_b}))})),
+        operand::ptr(new product({l_a, l_b, l_not_a, operand::ptr(new sum({l_b, l_c}))}))
+    })
+        assert(l_operand->reduce().get() == l_zero.get());
+
+    // Duplicate literals collapse, and the lone product comes out as expansion leaves it.
+    operand::ptr l_duplicated = operand::ptr(new product({
+        l_a,
+        operand::ptr(new product({l_a, l_b}))
+    }))->reduce();
+
+    assert(l_duplicated.get() == operand::ptr(new product({l_a, l_b}))->reduce().get());
+    assert(l_duplicated->to_string() == "((a && b && ) || )");
+
+}
+
+void test_distribution_budget(
+
+)
+{
+    using namespace ba_calculator;
+
+    // (a0 || b0 || c0) && (a1 || b1 || c1) && (a2 || b2 || c2) has 27 products.
+    std::set<operand::ptr> l_sums;
+
+    for (const auto& l_suffix : { "0", "1", "2" })
+        l_sums.insert(operand::ptr(new sum({
+            operand::ptr(new unresolved(std::string("budget_a") + l_suffix)),
+            operand::ptr(new unresolved(std::string("budget_b") + l_suffix)),
+            operand::ptr(new unresolved(std::string("budget_c") + l_suffix))
+        })));
+
+    operand::ptr l_product(new product(l_sums));
+
+    std::size_t l_budget = product::distribution_budget();
+
+    // The final step multiplies 9 products by 3.
+    product::set_distribution_budget(20);
+
+    bool l_is_thrown = false;
+
+    try
+    {
+        l_product->reduce();
+    }
+    catch (const distribution_budget_exceeded& a_exception)
+    {
+        l_is_thrown = true;
+        assert(a_exception.m_estimate == 27);
+        assert(a_exception.m_budget == 20);
+    }
+
+    assert(l_is_thrown);
+
+    product::set_distribution_budget(27);
+
+    operand::ptr l_reduced = l_product->reduce();
+    assert(((const sum&)*l_reduced).m_operands.size() == 27);
+
+    bdd_manager l_manager;
+    assert(l_manager.equivalent(l_reduced, l_product));
+
+    product::set_distribution_budget(l_budget);
+
+}
+
+void test_parallel_distribution(
+
+)
+{
+    using namespace ba_calculator;
+
+    // Two sums of 64 products each, whose cross product reaches the parallel threshold.
+    std::set<operand::ptr> l_sum_0;
+    std::set<operand::ptr> l_sum_1;
+
+    for (std::size_t i = 0; i < 64; i++)
+    {
+        operand::ptr l_x(new unresolved("parallel_x" + std::to_string(i)));
+        operand::ptr l_y(new unresolved("parallel_y" + std::to_string(i)));
+
+        operand::ptr l_z(new unresolved("parallel_z" + std::to_string(i % 8)));
+
+        l_sum_0.insert(operand::ptr(new product({l_x, l_z})));
+        l_sum_1.insert(i % 2 == 0 ? l_y : operand::ptr(new product({l_y, operand::ptr(new invert(l_z))})));
+    }
+
+    assert(l_sum_0.size() * l_sum_1.size() >= product::PARALLEL_DISTRIBUTION_THRESHOLD);
+
+    operand::ptr l_product(new product({
+        operand::ptr(new sum(l_sum_0)),
+        operand::ptr(new sum(l_sum_1))
+    }));
+
+    std::size_t l_thread_count = product::distribution_thread_count();
+
+    product::set_distribution_thread_count(1);
+    reduce_cache::clear();
+    operand::ptr l_serial = l_product->reduce();
+
+    product::set_distribution_thread_count(4);
+    reduce_cache::clear();
+    operand::ptr l_parallel = l_product->reduce();
+
+    // The 256 products holding some parallel_z in both polarities drop out either way.
+    assert(l_parallel.get() == l_serial.get());
+    assert(((const sum&)*l_parallel).m_operands.size() == 64 * 64 - 256);
+
+    product::set_distribution_thread_count(l_thread_count);
+    reduce_cache::clear();
+
+}
+
+void test_parallel_reduce(
+
+)
+{
+    using namespace ba_calculator;
+
+    // Eight independent branches, each large enough to be reduced as a job of its own.
+    std::set<operand::ptr> l_branches;
+
+    for (std::size_t i = 0; i < 8; i++)
+    {
+        std::string l_prefix = "task_" + std::to_string(i) + "_";
+
+        std::set<operand::ptr> l_products;
+
+        for (std::size_t j = 0; j < 16; j++)
+            l_products.insert(operand::ptr(new product({
+                operand::ptr(new unresolved(l_prefix + std::to_string(j))),
+                operand::ptr(new invert(operand::ptr(new unresolved(l_prefix + std::to_string(j + 1)))))
+            })));
+
+        l_branches.insert(operand::ptr(new product({
+            operand::ptr(new sum(l_products)),
+            operand::ptr(new sum({
+                operand::ptr(new unresolved(l_prefix + "a")),
+                operand::ptr(new unresolved(l_prefix + "b"))
+            }))
+        })));
+        
+    }
+
+    operand::ptr l_expression(new sum(l_branches));
+
+    for (const operand::ptr& l_branch : l_branches)
+        assert(l_branch->m_size >= operand::PARALLEL_REDUCE_THRESHOLD);
+
+    std::size_t l_thread_count = scheduler::thread_count();
+
+    scheduler::set_thread_count(4);
+
+    reduce_cache::clear();
+    operand::ptr l_sequential = l_expression->reduce(EXPANSION);
+
+    reduce_cache::clear();
+    operand::ptr l_parallel = l_expression->reduce(PARALLEL_EXPANSION);
+
+    assert(l_parallel.get() == l_sequential.get());
+    assert(!scheduler::is_parallel());
+
+    // Exceptions thrown by jobs surface from the reduction.
+    std::size_t l_budget = product::distribution_budget();
+    product::set_distribution_budget(1);
+
+    reduce_cache::clear();
+
+    bool l_is_thrown = false;
+
+    try
+    {
+        l_expression->reduce(PARALLEL_EXPANSION);
+    }
+    catch (const distribution_budget_exceeded& a_exception)
+    {
+        l_is_thrown = true;
+    }
+
+    assert(l_is_thrown);
+
+    product::set_distribution_budget(l_budget);
+    scheduler::set_thread_count(l_thread_count);
+    reduce_cache::clear();
+
+}
+
+void test_shared_operands(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("shared_a"));
+    operand::ptr l_b(new unresolved("shared_b"));
+
+    // Operands hand out references to themselves through their own owner.
+    long l_use_count = l_a.use_count();
+    operand::ptr l_simplified = l_a->simplify();
+
+    assert(l_simplified.get() == l_a.get());
+    assert(l_a.use_count() == l_use_count + 1);
+
+    // Threads which share one expression, and one cache, reduce it alike.
+    operand::ptr l_expression(new invert(operand::ptr(new product({
+        operand::ptr(new sum({l_a, operand::ptr(new invert(l_b))})),
+        operand::ptr(new sum({operand::ptr(new invert(l_a)), l_b}))
+    }))));
+
+    reduce_cache::clear();
+
+    std::vector<operand::ptr> l_results(4, operand::ptr(nullptr));
+    std::vector<std::thread> l_threads;
+
+    for (std::size_t i = 0; i < l_results.size(); i++)
+        l_threads.emplace_back(
+            [&l_expression, &l_results, i]()
+            {
+                l_results[i] = l_expression->reduce();
+            }
+        );
+
+    for (std::thread& l_thread : l_threads)
+        l_thread.join();
+
+    for (const operand::ptr& l_result : l_results)
+    {
+        assert(l_result.get() == l_results[0].get());
+        assert(reduce_cache::find(l_result).get() == l_result.get());
+        assert(l_result->reduce().get() == l_result.get());
+    }
+
+    assert(l_results[0]->to_string() == "((shared_a && !shared_b && ) || (shared_b && !shared_a && ) || )");
+
+    reduce_cache::clear();
+
+}
+
+void test_symbol_table(
+
+)
+{
+    using namespace ba_calculator;
+
+    std::size_t l_size = symbol_table::size();
+
+    std::size_t l_variable_0 = symbol_table::intern("symbol_0");
+    std::size_t l_variable_1 = symbol_table::intern("symbol_1");
+
+    // Identifiers receive dense ids, once.
+    assert(l_variable_0 == l_size);
+    assert(l_variable_1 == l_size + 1);
+    assert(symbol_table::intern("symbol_0") == l_variable_0);
+    assert(symbol_table::identifier(l_variable_1) == "symbol_1");
+
+    operand::ptr l_unresolved_0(new unresolved("symbol_0"));
+    operand::ptr l_unresolved_1(new unresolved(l_variable_0));
+
+    assert(l_unresolved_0.get() == l_unresolved_1.get());
+    assert(l_unresolved_0->to_string() == "symbol_0");
+
+    // Variables are ordered by id, not by name.
+    operand::ptr l_unresolved_2(new unresolved("a_symbol"));
+    assert(l_unresolved_0 < l_unresolved_2);
+
+    // Substituting an identifier which was never seen does not intern it.
+    l_size = symbol_table::size();
+    operand::ptr l_sub_0 = l_unresolved_0->substitute("never_seen", operand::ptr(new resolved(1)));
+    assert(symbol_table::size() == l_size);
+    assert(l_sub_0.get() == l_unresolved_0.get());
+
+    operand::ptr l_sub_1 = l_unresolved_0->substitute(l_variable_0, operand::ptr(new resolved(1)));
+    assert(l_sub_1->to_string() == "1");
+
+}
+
+void test_reduce_cache(
+
+)
+{
+    using namespace ba_calculator;
+
+    reduce_cache::clear();
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+    operand::ptr l_d(new unresolved("d"));
+
+    // The same subterm appearing under two different parents.
+    operand::ptr l_shared(new invert(operand::ptr(new sum({l_a, l_b}))));
+
+    operand::ptr l_product(new product({l_shared, l_c}));
+    operand::ptr l_sum(new sum({l_shared, l_d}));
+
+    l_product->reduce();
+
+    std::size_t l_hits = reduce_cache::hits();
+    std::size_t l_misses = reduce_cache::misses();
+
+    assert(l_misses > 0);
+
+    l_sum->reduce();
+
+    // The shared subterm was served from the cache the second time.
+    assert(reduce_cache::hits() > l_hits);
+
+    // Reducing the product again is a single hit.
+    l_hits = reduce_cache::hits();
+    l_misses = reduce_cache::misses();
+
+    l_product->reduce();
+
+    assert(reduce_cache::hits() == l_hits + 1);
+    assert(reduce_cache::misses() == l_misses);
+
+    // Shrinking the capacity evicts the least recently used entries.
+    std::size_t l_capacity = reduce_cache::capacity();
+
+    reduce_cache::set_capacity(2);
+    assert(reduce_cache::size() == 2);
+
+    reduce_cache::set_capacity(0);
+    assert(reduce_cache::size() == 0);
+
+    l_sum->reduce();
+    assert(reduce_cache::size() == 0);
+
+    reduce_cache::set_capacity(l_capacity);
+    reduce_cache::clear();
+
+}
+
+void test_structural_metrics(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_not_b(new invert(l_b));
+
+    operand::ptr l_product(new product({l_a, l_not_b}));
+    operand::ptr l_sum(new sum({l_product, l_b}));
+
+    assert(l_a->m_size == 1 && l_a->m_depth == 1);
+    assert(l_not_b->m_size == 2 && l_not_b->m_depth == 2);
+    assert(l_product->m_size == 4 && l_product->m_depth == 3);
+    assert(l_sum->m_size == 6 && l_sum->m_depth == 4);
+
+    // Operands may key unordered containers, where equal operands collapse.
+    std::unordered_set<operand::ptr> l_set = {
+        l_product,
+        operand::ptr(new product({operand::ptr(new invert(l_b)), l_a})),
+        l_sum
+    };
+
+    assert(l_set.size() == 2);
+    assert(std::hash<operand::ptr>()(l_product) == l_product->m_hash);
+
+}
+
+void test_batch_substitute(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+    operand::ptr l_d(new unresolved("d"));
+
+    operand::ptr l_untouched(new product({l_c, operand::ptr(new invert(l_d))}));
+    operand::ptr l_touched(new sum({l_a, operand::ptr(new invert(l_b))}));
+    operand::ptr l_root(new product({l_untouched, l_touched}));
+
+    // Bindings apply simultaneously: a's replacement is not itself substituted.
+    operand::ptr l_result = l_root->substitute(operand::substitutions({
+        {((const unresolved&)*l_a).m_variable, l_b},
+        {((const unresolved&)*l_b).m_variable, operand::ptr(new resolved(1))}
+    }));
+
+    operand::ptr l_expected(new product({
+        l_untouched,
+        operand::ptr(new sum({l_b, operand::ptr(new invert(operand::ptr(new resolved(1))))}))
+    }));
+
+    assert(l_result.get() == l_expected.get());
+
+    // The subtree which mentions no bound variable is the very same node.
+    const product& l_result_product = (const product&)*l_result;
+    assert(l_result_product.m_operands.count(l_untouched) == 1);
+
+    // Substituting only unbound variables returns the original root.
+    operand::ptr l_unchanged = l_root->substitute(operand::substitutions({
+        {symbol_table::intern("unbound"), l_a}
+    }));
+
+    assert(l_unchanged.get() == l_root.get());
+
+}
+
+void test_support(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+
+    std::size_t l_variable_a = ((const unresolved&)*l_a).m_variable;
+    std::size_t l_variable_b = ((const unresolved&)*l_b).m_variable;
+    std::size_t l_variable_c = ((const unresolved&)*l_c).m_variable;
+
+    operand::ptr l_left(new product({l_a, operand::ptr(new invert(l_b))}));
+    operand::ptr l_right(new sum({l_b, l_c, operand::ptr(new resolved(0))}));
+    operand::ptr l_root(new sum({l_left, l_right}));
+
+    assert(operand::ptr(new resolved(1))->support().empty());
+    assert(l_left->support() == std::vector<std::size_t>({l_variable_a, l_variable_b}));
+    assert(l_root->support() == std::vector<std::size_t>({l_variable_a, l_variable_b, l_variable_c}));
+
+    operand::substitutions l_bind_c = {{l_variable_c, operand::ptr(new resolved(1))}};
+
+    assert(!l_left->depends_on(l_bind_c));
+    assert(l_right->depends_on(l_bind_c));
+
+    // Only the branch which depends on c is rebuilt.
+    operand::ptr l_result = l_root->substitute(l_bind_c);
+    const sum& l_result_sum = (const sum&)*l_result;
+
+    assert(l_result_sum.m_operands.count(l_left) == 1);
+    assert(l_result_sum.m_operands.count(l_right) == 0);
+
+}
+
+void test_evaluator(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+
+    // !(a && (b || !c)) || (b && c), in which b is shared between branches.
+    operand::ptr l_expression(new sum({
+        operand::ptr(new invert(operand::ptr(new product({
+            l_a,
+            operand::ptr(new sum({l_b, operand::ptr(new invert(l_c))}))
+        })))),
+        operand::ptr(new product({l_b, l_c}))
+    }));
+
+    evaluator l_evaluator(l_expression);
+
+    assert(l_evaluator.m_variables == l_expression->support());
+
+    // Bit j of each input word enumerates assignment j over the three variables.
+    std::vector<std::uint64_t> l_inputs(3);
+
+    for (std::size_t j = 0; j < 8; j++)
+        for (std::size_t i = 0; i < 3; i++)
+            l_inputs[i] |= std::uint64_t((j >> i) & 1) << j;
+
+    std::uint64_t l_outputs = l_evaluator.evaluate(l_inputs);
+
+    for (std::size_t j = 0; j < 8; j++)
+    {
+        operand::substitutions l_assignment;
+
+        for (std::size_t i = 0; i < 3; i++)
+            l_assignment.insert({l_evaluator.m_variables[i], operand::ptr(new resolved((j >> i) & 1))});
+
+        const resolved& l_expected = (const resolved&)*l_expression->substitute(l_assignment)->reduce();
+
+        assert(((l_outputs >> j) & 1) == l_expected.m_value);
+        
+    }
+
+    // Words beyond the first block, including a partial final block,
+    // evaluate identically to the first word.
+    const std::size_t l_word_count = 7;
+
+    std::vector<std::uint64_t> l_wide_inputs(3 * l_word_count);
+
+    for (std::size_t i = 0; i < 3; i++)
+        std::fill_n(l_wide_inputs.begin() + i * l_word_count, l_word_count, l_inputs[i]);
+
+    std::vector<std::uint64_t> l_wide_outputs(l_word_count);
+
+    // The registers were sized when compiled, and are reused by every call.
+    const std::uint64_t* l_registers = l_evaluator.m_registers.data();
+
+    l_evaluator.evaluate(l_wide_inputs.data(), l_word_count, l_wide_outputs.data());
+
+    for (const std::uint64_t& l_word : l_wide_outputs)
+        assert(l_word == l_outputs);
+
+    assert(l_evaluator.evaluate(l_inputs) == l_outputs);
+    assert(l_evaluator.m_registers.data() == l_registers);
+
+}
+
+void test_bdd(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+    operand::ptr l_not_a(new invert(l_a));
+    operand::ptr l_not_b(new invert(l_b));
+
+    // a ^ b, written two different ways.
+    operand::ptr l_xor_0(new sum({
+        operand::ptr(new product({l_a, l_not_b})),
+        operand::ptr(new product({l_not_a, l_b}))
+    }));
+
+    operand::ptr l_xor_1(new product({
+        operand::ptr(new sum({l_a, l_b})),
+        operand::ptr(new invert(operand::ptr(new product({l_a, l_b}))))
+    }));
+
+    bdd_manager l_manager;
+
+    assert(l_manager.build(l_xor_0) == l_manager.build(l_xor_1));
+    assert(l_manager.equivalent(l_xor_0, l_xor_1));
+    assert(!l_manager.equivalent(l_xor_0, operand::ptr(new sum({l_a, l_b}))));
+
+    // The root of a ^ b tests a, and then tests b in opposite polarities.
+    const bdd_manager::node_entry& l_root = l_manager.m_nodes[l_manager.build(l_xor_0)];
+    const bdd_manager::node_entry& l_low = l_manager.m_nodes[l_root.m_low];
+    const bdd_manager::node_entry& l_high = l_manager.m_nodes[l_root.m_high];
+
+    assert(l_manager.m_order[l_root.m_level] == ((const unresolved&)*l_a).m_variable);
+    assert(l_low.m_low == l_high.m_high && l_low.m_high == l_high.m_low);
+
+    assert(l_manager.is_satisfiable(l_xor_0));
+    assert(!l_manager.is_satisfiable(operand::ptr(new product({l_xor_0, l_a, l_b}))));
+    assert(!l_manager.is_tautology(operand::ptr(new sum({l_xor_0, l_a, l_b}))));
+    assert(l_manager.is_tautology(operand::ptr(new sum({
+        l_xor_0,
+        operand::ptr(new product({l_a, l_b})),
+        operand::ptr(new product({l_not_a, l_not_b}))
+    }))));
+
+    // Reducing through the diagram yields the same operand as expansion, and
+    // preserves the function, whether or not the products are disjoint.
+    operand::ptr l_reduced = l_xor_1->reduce(DECISION_DIAGRAM);
+
+    assert(l_reduced.get() == l_xor_0->reduce().get());
+    assert(l_manager.equivalent(l_reduced, l_xor_1));
+
+    // The paths of a || b split it into a || (!a && b), which is widened back.
+    operand::ptr l_or(new sum({l_a, l_b}));
+    operand::ptr l_or_reduced = l_or->reduce(DECISION_DIAGRAM);
+
+    assert(l_or_reduced->to_string() == "((a && ) || (b && ) || )");
+    assert(l_or_reduced.get() == l_or->reduce().get());
+    assert(l_manager.equivalent(l_or_reduced, l_or));
+
+    for (const operand::ptr& l_operand : std::vector<operand::ptr>{
+        operand::ptr(new product({l_a, l_b})),
+        operand::ptr(new product({operand::ptr(new sum({l_a, l_b})), l_c})),
+        operand::ptr(new sum({operand::ptr(new product({l_a, l_b})), operand::ptr(new product({l_a, l_not_b}))})),
+        operand::ptr(new sum({operand::ptr(new product({l_a, l_b})), operand::ptr(new product({l_a, l_b, l_c}))})),
+        operand::ptr(new invert(operand::ptr(new product({l_a, operand::ptr(new sum({l_b, l_c}))}))))
+    })
+        assert(l_operand->reduce(DECISION_DIAGRAM).get() == l_operand->reduce().get());
+
+    operand::ptr l_constant = operand::ptr(new product({l_c, operand::ptr(new invert(l_c))}))->reduce(DECISION_DIAGRAM);
+    assert(l_constant->to_string() == "0");
+
+}
+
+void test_heuristic_minimizer(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+    operand::ptr l_not_a(new invert(l_a));
+    operand::ptr l_not_b(new invert(l_b));
+    operand::ptr l_not_c(new invert(l_c));
+
+    // (a && b) || (a && !b) merges into a.
+    operand::ptr l_merged = minimizer::heuristic(operand::ptr(new sum({
+        operand::ptr(new product({l_a, l_b})),
+        operand::ptr(new product({l_a, l_not_b}))
+    })));
+
+    assert(l_merged->to_string() == "((a && ) || )");
+
+    // Every minterm but !a && !b && !c, which is a || b || c.
+    std::set<operand::ptr> l_minterms;
+
+    for (std::size_t i = 1; i < 8; i++)
+        l_minterms.insert(operand::ptr(new product({
+            (i & 1) ? l_a : l_not_a,
+            (i & 2) ? l_b : l_not_b,
+            (i & 4) ? l_c : l_not_c
+        })));
+
+    operand::ptr l_expression(new sum(l_minterms));
+
+    operand::ptr l_minimized = minimizer::heuristic(l_expression);
+
+    assert(l_minimized->to_string() == "((a && ) || (b && ) || (c && ) || )");
+
+    bdd_manager l_manager;
+    assert(l_manager.equivalent(l_minimized, l_expression));
+
+    // Tautologies and contradictions collapse to constants.
+    assert(minimizer::heuristic(operand::ptr(new sum({l_expression, l_not_a})))->to_string() == "1");
+    assert(minimizer::heuristic(operand::ptr(new product({l_a, l_not_a})))->to_string() == "0");
+
+}
+
+void test_exact_minimizer(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+    operand::ptr l_not_a(new invert(l_a));
+    operand::ptr l_not_b(new invert(l_b));
+    operand::ptr l_not_c(new invert(l_c));
+
+    // The minterms 0, 1, 2, 5, 6 and 7 form a cyclic chart: none of the six
+    // primes is essential, and the minimum takes three of them.
+    std::set<operand::ptr> l_minterms;
+
+    for (const auto& i : { 0, 1, 2, 5, 6, 7 })
+        l_minterms.insert(operand::ptr(new product({
+            (i & 1) ? l_a : l_not_a,
+            (i & 2) ? l_b : l_not_b,
+            (i & 4) ? l_c : l_not_c
+        })));
+
+    operand::ptr l_cyclic(new sum(l_minterms));
+
+    bdd_manager l_manager;
+
+    for (const auto& l_thread_count : { 1, 4 })
+    {
+        operand::ptr l_minimized = minimizer::exact(l_cyclic, l_thread_count);
+
+        assert(l_manager.equivalent(l_minimized, l_cyclic));
+        assert(((const sum&)*l_minimized).m_operands.size() == 3);
+    }
+
+    // The majority function is exactly three products of two literals.
+    operand::ptr l_majority = minimizer::exact(operand::ptr(new sum({
+        operand::ptr(new product({l_a, l_b, l_not_c})),
+        operand::ptr(new product({l_a, l_not_b, l_c})),
+        operand::ptr(new product({l_not_a, l_b, l_c})),
+        operand::ptr(new product({l_a, l_b, l_c}))
+    })));
+
+    assert(l_majority->to_string() == "((a && b && ) || (a && c && ) || (b && c && ) || )");
+
+    assert(minimizer::exact(operand::ptr(new sum({l_a, l_not_a})))->to_string() == "1");
+    assert(minimizer::exact(operand::ptr(new product({l_a, l_not_a})))->to_string() == "0");
+
+}
+
+void test_expression(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+    operand::ptr l_not_a(new invert(l_a));
+    operand::ptr l_not_b(new invert(l_b));
+
+    operand::ptr l_xor(new product({
+        operand::ptr(new sum({l_a, l_b})),
+        operand::ptr(new invert(operand::ptr(new product({l_a, l_b}))))
+    }));
+
+    operand::ptr l_operand(new sum({
+        operand::ptr(new product({l_xor, l_c})),
+        operand::ptr(new invert(operand::ptr(new sum({l_xor, l_not_a, l_c}))))
+    }));
+
+    // Flattening is lossless, and renders and orders as the operands do.
+    expression l_expression(l_operand);
+
+    assert(l_expression.to_operand().get() == l_operand.get());
+    assert(l_expression.to_string() == l_operand->to_string());
+
+    // The shared subterm a ^ b is compiled once.
+    assert(l_expression.m_nodes.size() < l_operand->m_size);
+
+    std::vector<operand::ptr> l_operands = { l_a, l_not_b, l_xor, l_operand, operand::ptr(new resolved(1)) };
+
+    for (const operand::ptr& l_operand_0 : l_operands)
+        for (const operand::ptr& l_operand_1 : l_operands)
+            assert((expression(l_operand_0) < expression(l_operand_1)) == (l_operand_0 < l_operand_1));
+
+    // Substituted children are reordered, and coincident ones merged, as in a sum.
+    operand::ptr l_substituted = l_operand->substitute(operand::substitutions({{
+        ((const unresolved&)*l_c).m_variable, l_not_a
+    }}));
+
+    expression l_substituted_expression = l_expression.substitute(operand::substitutions({{
+        ((const unresolved&)*l_c).m_variable, l_not_a
+    }}));
+
+    assert(l_substituted_expression.to_string() == l_substituted->to_string());
+    assert(l_substituted_expression.to_operand().get() == l_substituted.get());
+
+    // Expanding the tagged nodes preserves the function.
+    bdd_manager l_manager;
+
+    for (const operand::ptr& l_reducible : { l_xor, l_operand, l_substituted })
+        assert(l_manager.equivalent(l_reducible->reduce(TAGGED_EXPANSION), l_reducible));
+
+    assert(operand::ptr(new product({l_a, l_not_a}))->reduce(TAGGED_EXPANSION)->to_string() == "0");
+    assert(operand::ptr(new sum({l_b, l_not_b}))->reduce(TAGGED_EXPANSION)->to_string() == "1");
+
+    // Unlike expansion, a lone literal still comes back as a sum of products.
+    assert(l_a->reduce(TAGGED_EXPANSION)->to_string() == "((a && ) || )");
+
+    // A budget of zero lifts the limit, as it does for product::expand().
+    std::set<operand::ptr> l_sums;
+
+    for (const auto& l_suffix : { "0", "1", "2" })
+        l_sums.insert(operand::ptr(new sum({
+            operand::ptr(new unresolved(std::string("tagged_a") + l_suffix)),
+            operand::ptr(new unresolved(std::string("tagged_b") + l_suffix)),
+            operand::ptr(new unresolved(std::string("tagged_c") + l_suffix))
+        })));
+
+    std::size_t l_budget = product::distribution_budget();
+    product::set_distribution_budget(0);
+
+    operand::ptr l_unbounded = operand::ptr(new product(l_sums))->reduce(TAGGED_EXPANSION);
+    assert(((const sum&)*l_unbounded).m_operands.size() == 27);
+
+    product::set_distribution_budget(l_budget);
+
+}
+
+bool cnf_satisfiable(
+    const ba_calculator::cnf& a_cnf,
+    const std::vector<bool>& a_assignment
+)
+{
+    using namespace ba_calculator;
+
+    // Try every extension of the assignment to the auxiliary variables.
+    std::size_t l_auxiliary_count = a_cnf.m_variable_count - a_assignment.size();
+
+    for (std::size_t l_extension = 0; l_extension < (std::size_t(1) << l_auxiliary_count); l_extension++)
+    {
+        auto l_value = [&](
+            const cnf::literal& a_literal
+        )
+        {
+            std::size_t l_index = std::abs(a_literal) - 1;
+
+            bool l_result = l_index < a_assignment.size() ?
+                a_assignment[l_index] :
+                ((l_extension >> (l_index - a_assignment.size())) & 1);
+
+            return a_literal > 0 ? l_result : !l_result;
+        };
+
+        bool l_is_satisfied = std::all_of(
+            a_cnf.m_clauses.begin(),
+            a_cnf.m_clauses.end(),
+            [&](
+                const cnf::clause& a_clause
+            )
+            {
+                return std::any_of(a_clause.begin(), a_clause.end(), l_value);
+            }
+        );
+
+        if (l_is_satisfied)
+            return true;
+    }
+
+    return false;
+
+}
+
+void test_cnf(
+
+)
+{
+    using namespace ba_calculator;
+
+    std::vector<operand::ptr> l_variables;
+
+    for (const auto& l_identifier : { "a", "b", "c", "d", "e", "f", "g", "h" })
+        l_variables.push_back(operand::ptr(new unresolved(l_identifier)));
+
+    // A sum of disjoint pairs, whose clauses by distribution number 2^4.
+    std::vector<operand::ptr> l_pairs;
+
+    for (std::size_t i = 0; i < l_variables.size(); i += 2)
+        l_pairs.push_back(operand::ptr(new product({l_variables[i], l_variables[i + 1]})));
+
+    operand::ptr l_pairs_sum(new sum(l_pairs));
+
+    cnf l_distributed = cnf::distribute(l_pairs_sum);
+    cnf l_encoded = cnf::tseitin(l_pairs_sum);
+
+    assert(l_distributed.m_clauses.size() == 16);
+    assert(l_distributed.m_variable_count == 8);
+
+    // One variable per product, with three clauses each, plus the top-level clause.
+    assert(l_encoded.m_variable_count == 8 + 4);
+    assert(l_encoded.m_clauses.size() == 4 * 3 + 1);
+
+    operand::ptr l_mixed(new product({
+        operand::ptr(new sum({
+            operand::ptr(new invert(l_pairs[0])),
+            operand::ptr(new product({l_variables[4], operand::ptr(new invert(l_variables[1]))}))
+        })),
+        operand::ptr(new invert(operand::ptr(new sum({l_variables[0], l_variables[5]})))),
+        operand::ptr(new sum({l_variables[3], operand::ptr(new resolved(0))}))
+    }));
+
+    // Every encoding is satisfied by exactly the assignments satisfying the operand.
+    for (const operand::ptr& l_operand : { l_pairs_sum, l_mixed })
+    {
+        std::vector<cnf> l_cnfs = { cnf::distribute(l_operand), cnf::tseitin(l_operand), cnf(l_operand) };
+
+        const std::vector<std::size_t>& l_support = l_operand->support();
+
+        for (std::size_t l_minterm = 0; l_minterm < (std::size_t(1) << l_support.size()); l_minterm++)
+        {
+            std::vector<bool> l_assignment;
+            operand::substitutions l_substitutions;
+
+            for (std::size_t i = 0; i < l_support.size(); i++)
+            {
+                l_assignment.push_back((l_minterm >> i) & 1);
+                l_substitutions.emplace(l_support[i], operand::ptr(new resolved((l_minterm >> i) & 1)));
+            }
+
+            bool l_expected = l_operand->substitute(l_substitutions)->reduce()->to_string() == "1";
+
+            for (const cnf& l_cnf : l_cnfs)
+                assert(cnf_satisfiable(l_cnf, l_assignment) == l_expected);
+        }
+    }
+
+    assert(cnf::tseitin(operand::ptr(new resolved(0))).m_clauses == std::vector<cnf::clause>{ {} });
+    assert(cnf::tseitin(operand::ptr(new resolved(1))).m_clauses.empty());
+
+    cnf l_literal(operand::ptr(new invert(l_variables[1])));
+
+    assert(l_literal.to_dimacs() == "c 1 b\np cnf 1 1\n-1 0\n");
+
+}
+
+void test_solver(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_not_a(new invert(l_a));
+    operand::ptr l_not_b(new invert(l_b));
+
+    operand::ptr l_xor_0(new sum({
+        operand::ptr(new product({l_a, l_not_b})),
+        operand::ptr(new product({l_not_a, l_b}))
+    }));
+
+    operand::ptr l_xor_1(new product({
+        operand::ptr(new sum({l_a, l_b})),
+        operand::ptr(new invert(operand::ptr(new product({l_a, l_b}))))
+    }));
+
+    assert(solver::equivalent(l_xor_0, l_xor_1));
+    assert(!solver::equivalent(l_xor_0, operand::ptr(new sum({l_a, l_b}))));
+    assert(solver::is_satisfiable(l_xor_0));
+    assert(!solver::is_satisfiable(operand::ptr(new product({l_xor_0, l_a, l_b}))));
+    assert(solver::is_tautology(operand::ptr(new sum({l_xor_0, l_xor_1, l_a, l_b}))) == false);
+    assert(solver::is_tautology(operand::ptr(new sum({l_xor_0, operand::ptr(new product({l_a, l_b})), operand::ptr(new product({l_not_a, l_not_b}))}))));
+    assert(!solver::is_satisfiable(operand::ptr(new resolved(0))));
+    assert(solver::is_tautology(operand::ptr(new resolved(1))));
+
+    // Five pigeons do not fit into four holes. Refuting this takes learning.
+    const std::size_t l_pigeons = 5;
+    const std::size_t l_holes = 4;
+
+    std::vector<std::vector<operand::ptr>> l_in(l_pigeons);
+    std::vector<operand::ptr> l_constraints;
+
+    for (std::size_t i = 0; i < l_pigeons; i++)
+    {
+        for (std::size_t j = 0; j < l_holes; j++)
+            l_in[i].push_back(operand::ptr(new unresolved("p" + std::to_string(i) + "h" + std::to_string(j))));
+
+        l_constraints.push_back(operand::ptr(new sum(l_in[i])));
+    }
+
+    for (std::size_t j = 0; j < l_holes; j++)
+        for (std::size_t i = 0; i < l_pigeons; i++)
+            for (std::size_t k = i + 1; k < l_pigeons; k++)
+                l_constraints.push_back(operand::ptr(new invert(operand::ptr(new product({l_in[i][j], l_in[k][j]})))));
+
+    operand::ptr l_pigeonhole(new product(l_constraints));
+
+    solver l_refuter(cnf::tseitin(l_pigeonhole));
+
+    assert(!l_refuter.solve());
+    assert(l_refuter.conflict_count() > 0);
+
+    // With a hole to spare, the model found places each pigeon in a hole of its own.
+    l_constraints.erase(l_constraints.begin() + l_holes, l_constraints.begin() + l_pigeons);
+
+    cnf l_cnf = cnf::tseitin(operand::ptr(new product(l_constraints)));
+    solver l_placer(l_cnf);
+
+    std::set<std::size_t> l_models;
+
+    while (l_placer.solve())
+    {
+        std::size_t l_model = 0;
+        cnf::clause l_blocking;
+
+        for (std::size_t i = 0; i < l_holes; i++)
+            for (std::size_t j = 0; j < l_holes; j++)
+            {
+                cnf::literal l_variable = l_cnf.variable(((const unresolved&)*l_in[i][j]).m_variable);
+
+                if (l_placer.value(l_variable))
+                    l_model |= std::size_t(1) << (i * l_holes + j);
+
+                l_blocking.push_back(l_placer.value(l_variable) ? -l_variable : l_variable);
+            }
+
+        for (std::size_t j = 0; j < l_holes; j++)
+            assert(std::popcount((l_model >> j) & 0x1111) <= 1);
+
+        l_models.insert(l_model);
+        l_placer.add_clause(l_blocking);
+    }
+
+    // Each pigeon takes at least one hole, and no two share one. The
+    // blocked models are distinct, and there is nothing left to find.
+    std::size_t l_expected = 0;
+
+    for (std::size_t l_model = 0; l_model < (std::size_t(1) << (l_holes * l_holes)); l_model++)
+    {
+        bool l_is_model = true;
+
+        for (std::size_t i = 0; i < l_holes; i++)
+            l_is_model = l_is_model && ((l_model >> (i * l_holes)) & 0xf) != 0;
+
+        for (std::size_t j = 0; j < l_holes; j++)
+            l_is_model = l_is_model && std::popcount((l_model >> j) & 0x1111) <= 1;
+
+        l_expected += l_is_model;
+    }
+
+    assert(l_models.size() == l_expected);
+
+    // Equivalence of operands far too large to expand: a product of sums
+    // against its De Morgan dual, which distributes into 2^40 products.
+    std::vector<operand::ptr> l_sums;
+    std::vector<operand::ptr> l_products;
+
+    for (std::size_t i = 0; i < 40; i++)
+    {
+        operand::ptr l_x(new unresolved("x" + std::to_string(i)));
+        operand::ptr l_y(new unresolved("y" + std::to_string(i)));
+
+        l_sums.push_back(operand::ptr(new sum({l_x, l_y})));
+        l_products.push_back(operand::ptr(new product({operand::ptr(new invert(l_x)), operand::ptr(new invert(l_y))})));
+    }
+
+    operand::ptr l_conjunction(new product(l_sums));
+    operand::ptr l_dual(new invert(operand::ptr(new sum(l_products))));
+
+    assert(solver::equivalent(l_conjunction, l_dual));
+    assert(!solver::equivalent(l_conjunction, operand::ptr(new product({l_dual, l_sums[0], l_not_a}))));
+
+}
+
+void test_model_counter(
+
+)
+{
+    using namespace ba_calculator;
+
+    assert((natural(0xffffffffffffffffULL) + natural(1)).to_string() == "18446744073709551616");
+    assert((natural::power_of_two(64) - natural(1)).to_string() == "18446744073709551615");
+    assert((natural(1000000007) * natural(1000000009)).to_string() == "1000000016000000063");
+    assert(natural::power_of_two(100).to_string() == "1267650600228229401496703205376");
+    assert(natural(3) < natural::power_of_two(40) && !(natural::power_of_two(40) < natural(3)));
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+    operand::ptr l_not_a(new invert(l_a));
+
+    std::vector<operand::ptr> l_operands = {
+        operand::ptr(new sum({l_a, l_b})),
+        operand::ptr(new product({l_a, l_not_a})),
+        operand::ptr(new sum({
+            operand::ptr(new product({l_a, l_b})),
+            operand::ptr(new invert(operand::ptr(new sum({l_not_a, l_c, operand::ptr(new resolved(0))}))))
+        })),
+        operand::ptr(new product({
+            operand::ptr(new sum({l_a, l_b})),
+            operand::ptr(new sum({l_not_a, l_c})),
+            operand::ptr(new invert(operand::ptr(new product({l_b, l_c}))))
+        }))
+    };
+
+    // Counts agree with enumerating every assignment.
+    model_counter l_counter;
+
+    for (const operand::ptr& l_operand : l_operands)
+    {
+        const std::vector<std::size_t>& l_support = l_operand->support();
+
+        std::size_t l_expected = 0;
+
+        for (std::size_t l_minterm = 0; l_minterm < (std::size_t(1) << l_support.size()); l_minterm++)
+        {
+            operand::substitutions l_substitutions;
+
+            for (std::size_t i = 0; i < l_support.size(); i++)
+                l_substitutions.emplace(l_support[i], operand::ptr(new resolved((l_minterm >> i) & 1)));
+
+            l_expected += l_operand->substitute(l_substitutions)->reduce()->to_string() == "1";
+        }
+
+        assert(l_counter.count_models(l_operand) == natural(l_expected));
+    }
+
+    // 100 disjoint sums of two variables have 3^100 models, found by decomposition.
+    std::vector<operand::ptr> l_sums;
+    natural l_power(1);
+
+    for (std::size_t i = 0; i < 100; i++)
+    {
+        l_sums.push_back(operand::ptr(new sum({
+            operand::ptr(new unresolved("x" + std::to_string(i))),
+            operand::ptr(new unresolved("y" + std::to_string(i)))
+        })));
+
+        l_power = l_power * natural(3);
+    }
+
+    assert(l_counter.count_models(operand::ptr(new product(l_sums))) == l_power);
+    assert(l_power.to_string() == "515377520732011331036461129765621272702107522001");
+
+    // The parity of 200 variables holds on half of the assignments. Each level of
+    // the chain cofactors into another level, or its inversion, from the cache.
+    operand::ptr l_parity(new unresolved("z0"));
+
+    for (std::size_t i = 1; i < 200; i++)
+    {
+        operand::ptr l_z(new unresolved("z" + std::to_string(i)));
+
+        l_parity = operand::ptr(new sum({
+            operand::ptr(new product({l_parity, operand::ptr(new invert(l_z))})),
+            operand::ptr(new product({operand::ptr(new invert(l_parity)), l_z}))
+        }));
+    }
+
+    model_counter l_parity_counter;
+
+    assert(l_parity_counter.count_models(l_parity) == natural::power_of_two(199));
+    assert(l_parity_counter.cache_hits() > 0);
+
+}
+
+void test_enumerator(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+    operand::ptr l_not_b(new invert(l_b));
+
+    operand::ptr l_operand(new sum({
+        operand::ptr(new product({l_a, l_not_b})),
+        operand::ptr(new product({l_b, l_c})),
+        operand::ptr(new invert(operand::ptr(new sum({l_a, l_c}))))
+    }));
+
+    // The cubes are disjoint, and the assignments are exactly the satisfying ones.
+    enumerator l_cubes(l_operand);
+    cube l_cube(0);
+    std::size_t l_cube_assignments = 0;
+
+    while (l_cubes.next_cube(l_cube))
+        l_cube_assignments += std::size_t(1) << (l_cubes.variables().size() - l_cube.literal_count());
+
+    enumerator l_assignments(l_operand);
+    std::vector<bool> l_assignment;
+    std::set<std::vector<bool>> l_found;
+
+    while (l_assignments.next_assignment(l_assignment))
+    {
+        operand::substitutions l_substitutions;
+
+        for (std::size_t i = 0; i < l_assignment.size(); i++)
+            l_substitutions.emplace(l_assignments.variables()[i], operand::ptr(new resolved(l_assignment[i])));
+
+        assert(l_operand->substitute(l_substitutions)->reduce()->to_string() == "1");
+        assert(l_found.insert(l_assignment).second);
+    }
+
+    assert(l_found.size() == 6);
+    assert(l_cube_assignments == l_found.size());
+
+    assert(!enumerator(operand::ptr(new product({l_a, operand::ptr(new invert(l_a))}))).next_cube(l_cube));
+
+    enumerator l_constant(operand::ptr(new resolved(1)));
+
+    assert(l_constant.next_assignment(l_assignment) && l_assignment.empty());
+    assert(!l_constant.next_assignment(l_assignment));
+
+    // The first few of the 2^60 - 1 assignments of a wide sum come
+    // straight away, without materializing any of the rest.
+    std::vector<operand::ptr> l_variables;
+
+    for (std::size_t i = 0; i < 60; i++)
+        l_variables.push_back(operand::ptr(new unresolved("w" + std::to_string(i))));
+
+    enumerator l_wide(operand::ptr(new sum(l_variables)));
+
+    for (std::size_t i = 0; i < 1000; i++)
+    {
+        assert(l_wide.next_assignment(l_assignment));
+        assert(std::find(l_assignment.begin(), l_assignment.end(), true) != l_assignment.end());
+    }
+
+}
+
+void test_dnf_view(
+
+)
+{
+    using namespace ba_calculator;
+
+    operand::ptr l_a(new unresolved("a"));
+    operand::ptr l_b(new unresolved("b"));
+    operand::ptr l_c(new unresolved("c"));
+    operand::ptr l_not_a(new invert(l_a));
+    operand::ptr l_not_b(new invert(l_b));
+
+    // Of the four combinations, the two holding a variable in both polarities are dropped.
+    dnf_view l_xor(operand::ptr(new product({
+        operand::ptr(new sum({l_a, l_b})),
+        operand::ptr(new sum({l_not_a, l_not_b}))
+    })));
+
+    std::vector<operand::ptr> l_products;
+    operand::ptr l_product(nullptr);
+
+    while (l_xor.next(l_product))
+        l_products.push_back(l_product);
+
+    assert(l_products.size() == 2);
+    assert(solver::equivalent(operand::ptr(new sum(l_products)), operand::ptr(new sum({
+        operand::ptr(new product({l_a, l_not_b})),
+        operand::ptr(new product({l_not_a, l_b}))
+    }))));
+
+    // Starting over yields the same products again.
+    l_xor.reset();
+
+    for (const operand::ptr& l_expected : l_products)
+        assert(l_xor.next(l_product) && l_product.get() == l_expected.get());
+
+    assert(!l_xor.next(l_product));
+
+    // The products together are equivalent to the operand, with inversions pushed down.
+    operand::ptr l_operand(new sum({
+        operand::ptr(new product({l_c, operand::ptr(new invert(operand::ptr(new product({l_a, l_not_b}))))})),
+        operand::ptr(new invert(operand::ptr(new sum({l_c, operand::ptr(new resolved(0)), operand::ptr(new product({l_a, l_b}))}))))
+    }));
+
+    dnf_view l_view(l_operand);
+
+    l_products.clear();
+
+    while (l_view.next(l_product))
+    {
+        assert(l_product->m_operand_type == PRODUCT);
+        l_products.push_back(l_product);
+    }
+
+    assert(solver::equivalent(operand::ptr(new sum(l_products)), l_operand));
+
+    dnf_view l_one(operand::ptr(new sum({l_a, operand::ptr(new resolved(1))})));
+
+    // The 1 comes out as the empty product, so that every yield is a product.
+    assert(l_one.next(l_product) && l_product->to_string() == "(a && )");
+    assert(l_one.next(l_product) && l_product->m_operand_type == PRODUCT && l_product->to_string() == "()");
+    assert(!l_one.next(l_product));
+
+    assert(!dnf_view(operand::ptr(new product({l_a, l_not_a}))).next(l_product));
+
+    // A product with an operand which yields nothing, whether 0 or a product
+    // whose own terms all conflict, is empty however wide its other operands are.
+    std::vector<operand::ptr> l_wide_sums;
+
+    for (std::size_t i = 0; i < 40; i++)
+        l_wide_sums.push_back(operand::ptr(new sum({
+            operand::ptr(new unresolved("empty_x" + std::to_string(i))),
+            operand::ptr(new unresolved("empty_y" + std::to_string(i)))
+        })));
+
+    std::vector<operand::ptr> l_zero_operands = l_wide_sums;
+    l_zero_operands.push_back(operand::ptr(new sum({operand::ptr(new resolved(0)), operand::ptr(new resolved(0))})));
+
+    assert(!dnf_view(operand::ptr(new product(l_zero_operands))).next(l_product));
+
+    std::vector<operand::ptr> l_conflicting_operands = l_wide_sums;
+    l_conflicting_operands.push_back(operand::ptr(new sum({
+        operand::ptr(new product({l_a, l_not_a})),
+        operand::ptr(new product({l_b, l_not_b}))
+    })));
+
+    assert(!dnf_view(operand::ptr(new product(l_conflicting_operands))).next(l_product));
+
+    // A product of 40 sums distributes into 2^40 products, but
+    // the first few come straight away, one at a time.
+    std::vector<operand::ptr> l_sums;
+
+    for (std::size_t i = 0; i < 40; i++)
+        l_sums.push_back(operand::ptr(new sum({
+            operand::ptr(new unresolved("x" + std::to_string(i))),
+            operand::ptr(new unresolved("y" + std::to_string(i)))
+        })));
+
+    dnf_view l_wide(operand::ptr(new product(l_sums)));
+    std::unordered_set<operand::ptr> l_distinct;
+
+    for (std::size_t i = 0; i < 1000; i++)
+    {
+        assert(l_wide.next(l_product));
+        assert(((const product&)*l_product).m_operands.size() == 40);
+        l_distinct.insert(l_product);
+    }
+
+    assert(l_distinct.size() == 1000);
+
+    // Each level shares the one below between both its products, so the operand
+    // is a chain of 100 nodes, but would unfold into a tree of 2^100 of them.
+    operand::ptr l_chain(new unresolved("chain_c"));
+
+    for (std::size_t i = 0; i < 100; i++)
+        l_chain = operand::ptr(new sum({
+            operand::ptr(new product({l_chain, operand::ptr(new unresolved("chain_a" + std::to_string(i)))})),
+            operand::ptr(new product({l_chain, operand::ptr(new unresolved("chain_b" + std::to_string(i)))}))
+        }));
+
+    dnf_view l_chain_view(l_chain);
+
+    l_distinct.clear();
+
+    for (std::size_t i = 0; i < 1000; i++)
+    {
+        assert(l_chain_view.next(l_product));
+        assert(((const product&)*l_product).m_operands.size() == 101);
+        l_distinct.insert(l_product);
+    }
+
+    assert(l_distinct.size() == 1000);
+
+    // Starting over recycles the cursors, and yields the same first product.
+    operand::ptr l_first(nullptr);
+    l_chain_view.reset();
+    assert(l_chain_view.next(l_first));
+    l_chain_view.reset();
+    assert(l_chain_view.next(l_product) && l_product.get() == l_first.get());
+
+}
+
 void unit_test_main(
 
 )
 {
     test_invert();
+    test_unique_table();
+    test_arena();
+    test_cube();
+    test_cube_trie();
+    test_sorted_vector();
+    test_merge_opposites();
+    test_distribution_budget();
+    test_parallel_distribution();
+    test_parallel_reduce();
+    test_shared_operands();
+    test_symbol_table();
+    test_reduce_cache();
+    test_structural_metrics();
+    test_batch_substitute();
+    test_support();
+    test_evaluator();
+    test_bdd();
+    test_heuristic_minimizer();
+    test_exact_minimizer();
+    test_expression();
+    test_cnf();
+    test_solver();
+    test_model_counter();
+    test_enumerator();
+    test_dnf_view();
 }
 
 int main(
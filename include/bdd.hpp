@@ -0,0 +1,172 @@
+#ifndef BDD_HPP
+#define BDD_HPP
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "include/calculator.hpp"
+
+namespace ba_calculator
+{
+    // A reduced, ordered binary decision diagram manager. Every function built by
+    // a manager is represented canonically for the manager's variable order, so
+    // equivalence is an index compare and satisfiability is a terminal check,
+    // without ever expanding into a sum of products.
+    struct bdd_manager
+    {
+        typedef std::uint32_t node;
+
+        static constexpr node FALSE_NODE = 0;
+        static constexpr node TRUE_NODE = 1;
+
+        struct node_entry
+        {
+            // The position of the node's variable in the order.
+            std::size_t m_level;
+            node        m_low;
+            node        m_high;
+        };
+
+        // The variable id at each level, and the level of each variable id.
+        std::vector<std::size_t>                     m_order;
+        std::unordered_map<std::size_t, std::size_t> m_levels;
+
+        std::vector<node_entry> m_nodes;
+
+        bdd_manager(
+
+        );
+
+        // Variables missing from the given order are appended as they are encountered.
+        bdd_manager(
+            const std::vector<std::size_t>& a_order
+        );
+
+        // Orders variables by their first appearance in a depth-first walk of the
+        // operand, which keeps related variables close together in the order.
+        static std::vector<std::size_t> depth_first_order(
+            const operand::ptr& a_operand
+        );
+
+        node variable(
+            const std::size_t& a_variable
+        );
+
+        // If-then-else: (a_if && a_then) || (!a_if && a_else).
+        node ite(
+            const node& a_if,
+            const node& a_then,
+            const node& a_else
+        );
+
+        node negate(
+            const node& a_node
+        );
+
+        node conjoin(
+            const node& a_node_0,
+            const node& a_node_1
+        );
+
+        node disjoin(
+            const node& a_node_0,
+            const node& a_node_1
+        );
+
+        node build(
+            const operand::ptr& a_operand
+        );
+
+        // Returns a sum of products, or a resolved operand for the terminals. Each
+        // path to the true terminal is widened into a prime implicant, and the
+        // cubes are pruned as operand::reduce() prunes its own, so a || b comes
+        // back as a || b rather than as the disjoint paths a || (!a && b).
+        operand::ptr to_operand(
+            const node& a_node
+        ) const;
+
+        bool equivalent(
+            const operand::ptr& a_operand_0,
+            const operand::ptr& a_operand_1
+        );
+
+        bool is_satisfiable(
+            const operand::ptr& a_operand
+        );
+
+        bool is_tautology(
+            const operand::ptr& a_operand
+        );
+
+        std::size_t size(
+
+        ) const;
+
+    private:
+        struct triple
+        {
+            std::size_t m_0;
+            std::size_t m_1;
+            std::size_t m_2;
+
+            bool operator==(
+                const triple& a_triple
+            ) const;
+        };
+
+        struct triple_hasher
+        {
+            std::size_t operator()(
+                const triple& a_triple
+            ) const;
+        };
+
+        // Maps (level, low, high) to the node, so that no two nodes are alike.
+        std::unordered_map<triple, node, triple_hasher> m_unique;
+
+        // Maps (if, then, else) to the result of ite().
+        std::unordered_map<triple, node, triple_hasher> m_computed;
+
+        std::size_t level(
+            const std::size_t& a_variable
+        );
+
+        node make(
+            const std::size_t& a_level,
+            const node& a_low,
+            const node& a_high
+        );
+
+        void cofactor(
+            const node& a_node,
+            const std::size_t& a_level,
+            node& a_low,
+            node& a_high
+        ) const;
+
+        node build(
+            const operand& a_operand,
+            std::unordered_map<const operand*, node>& a_built
+        );
+
+        // Collects the paths to the true terminal, as the polarity of each level.
+        void collect_paths(
+            const node& a_node,
+            std::map<std::size_t, bool>& a_path,
+            std::vector<std::map<std::size_t, bool>>& a_paths
+        ) const;
+
+        // Whether the node holds under every assignment which extends the cube.
+        bool implies(
+            const std::map<std::size_t, bool>& a_cube,
+            const node& a_node,
+            std::unordered_map<node, bool>& a_implied
+        ) const;
+
+    };
+
+}
+
+#endif
@@ -4,6 +4,23 @@
 #include <string>
 #include <memory>
 #include <set>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace ba_calculator
 {
@@ -16,24 +33,520 @@ namespace ba_calculator
         PRODUCT = 4,
         SUM = 5
     };
+
+    enum reduction_strategies
+    {
+        // Distribute into a sum of products, pruning covered products.
+        EXPANSION = 0,
+        // Build a binary decision diagram, and widen the products on its paths into
+        // primes, pruned as EXPANSION prunes its own.
+        DECISION_DIAGRAM = 1,
+        // Expand as EXPANSION does, reducing independent operands as tasks on the scheduler.
+        PARALLEL_EXPANSION = 2,
+        // Expand over an expression of tagged nodes rather than operands. The result
+        // is an equivalent sum of products, though not necessarily the operand that
+        // EXPANSION gives: a lone literal still comes back as a sum of one product.
+        TAGGED_EXPANSION = 3
+    };
     
-    struct operand
+    // Maps variable identifiers to dense integer ids, once per process, so that
+    // operands compare and substitute variables by id. The identifiers
+    // themselves are only consulted when rendering operands as strings.
+    struct symbol_table
+    {
+        static const std::size_t npos = std::size_t(-1);
+
+        static std::size_t intern(
+            const std::string& a_identifier
+        );
+
+        // Returns npos if the identifier has never been interned.
+        static std::size_t find(
+            const std::string& a_identifier
+        );
+
+        static const std::string& identifier(
+            const std::size_t& a_variable
+        );
+
+        static std::size_t size(
+
+        );
+
+    private:
+        struct entries_type
+        {
+            std::unordered_map<std::string, std::size_t> m_variables;
+            std::deque<std::string>                      m_identifiers;
+            std::mutex                                   m_mutex;
+        };
+
+        static entries_type& entries(
+
+        );
+
+    };
+
+    // A bump allocator for operands. While an arena::scope is open on a thread,
+    // every operand (and its reference-count block) created on that thread is
+    // carved out of the arena's contiguous slabs. Individual frees only
+    // decrement a live count; the slabs are released all at once, when the
+    // scope has closed and the last operand allocated from it has died. Thus,
+    // results which escape the scope remain valid for as long as they are held.
+    //
+    // Jobs forked through the scheduler allocate from the arena of the thread
+    // which forked them. Closing a scope drops the reduce_cache entries made
+    // under it, so that the cache alone never keeps the slabs alive.
+    struct arena
+    {
+        struct scope
+        {
+            arena* m_arena;
+            arena* m_previous;
+
+            ~scope(
+
+            );
+
+            scope(
+                const std::size_t& a_slab_size = 1 << 16
+            );
+
+        };
+
+        // Makes the calling thread allocate from an arena whose scope is open on
+        // another thread, for its lifetime. The scope must outlive it.
+        struct adoption
+        {
+            arena* m_previous;
+
+            ~adoption(
+
+            );
+
+            adoption(
+                arena* a_arena
+            );
+
+        };
+
+        std::vector<char*> m_slabs;
+        std::size_t        m_slab_size;
+        std::size_t        m_offset;
+        std::size_t        m_live_allocations;
+        bool               m_is_open;
+
+    private:
+        // Operands carved out of the arena may die on any thread.
+        std::mutex         m_mutex;
+
+    public:
+
+        static void* allocate(
+            const std::size_t& a_size
+        );
+
+        static void deallocate(
+            void* a_pointer
+        );
+
+        static arena* current(
+
+        );
+
+    private:
+        ~arena(
+
+        );
+
+        arena(
+            const std::size_t& a_slab_size
+        );
+
+        void* bump(
+            const std::size_t& a_size
+        );
+
+        void release(
+            char* a_block,
+            const std::size_t& a_size
+        );
+
+    };
+
+    // Routes the reference-count blocks of operand::ptr through the arena as well.
+    template<typename T>
+    struct arena_allocator
+    {
+        typedef T value_type;
+
+        arena_allocator(
+
+        ) = default;
+
+        template<typename U>
+        arena_allocator(
+            const arena_allocator<U>&
+        )
+        {
+
+        }
+
+        T* allocate(
+            const std::size_t& a_count
+        )
+        {
+            return (T*)arena::allocate(a_count * sizeof(T));
+        }
+
+        void deallocate(
+            T* a_pointer,
+            const std::size_t&
+        )
+        {
+            // Every block records its own size.
+            arena::deallocate(a_pointer);
+        }
+
+        template<typename U>
+        bool operator==(
+            const arena_allocator<U>&
+        ) const
+        {
+            return true;
+        }
+
+    };
+
+    // An immutable sequence of distinct elements in ascending order, built once.
+    // Up to N elements are stored inline, so that small sequences need no storage
+    // of their own and are iterated without chasing pointers. Larger sequences
+    // are stored contiguously, alongside the arena's other allocations.
+    template<typename T, std::size_t N>
+    struct sorted_vector
+    {
+        typedef T        value_type;
+        typedef const T* const_iterator;
+        typedef const T* iterator;
+
+        typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+        ~sorted_vector(
+
+        )
+        {
+            for (std::size_t i = 0; i < m_size; i++)
+                m_data[i].~T();
+
+            if (m_data != inline_data())
+                arena::deallocate(m_data);
+        }
+
+        sorted_vector(
+            std::initializer_list<T> a_elements
+        ) :
+            sorted_vector(std::vector<T>(a_elements))
+        {
+
+        }
+
+        // Sorts the elements, and drops the duplicates.
+        sorted_vector(
+            std::vector<T> a_elements
+        )
+        {
+            std::sort(a_elements.begin(), a_elements.end());
+
+            a_elements.erase(
+                std::unique(
+                    a_elements.begin(),
+                    a_elements.end(),
+                    [](
+                        const T& a_element_0,
+                        const T& a_element_1
+                    )
+                    {
+                        return !(a_element_0 < a_element_1) && !(a_element_1 < a_element_0);
+                    }
+                ),
+                a_elements.end()
+            );
+
+            assign(std::make_move_iterator(a_elements.begin()), a_elements.size());
+        }
+
+        sorted_vector(
+            const std::set<T>& a_elements
+        )
+        {
+            assign(a_elements.begin(), a_elements.size());
+        }
+
+        sorted_vector(
+            const sorted_vector& a_elements
+        )
+        {
+            assign(a_elements.begin(), a_elements.size());
+        }
+
+        sorted_vector(
+            sorted_vector&& a_elements
+        )
+        {
+            if (a_elements.m_data != a_elements.inline_data())
+            {
+                // Take over the storage outright.
+                m_size = a_elements.m_size;
+                m_data = a_elements.m_data;
+                a_elements.m_size = 0;
+                a_elements.m_data = a_elements.inline_data();
+                return;
+            }
+
+            assign(std::make_move_iterator(a_elements.m_data), a_elements.m_size);
+        }
+
+        sorted_vector& operator=(
+            const sorted_vector& a_elements
+        ) = delete;
+
+        const_iterator begin(
+
+        ) const
+        {
+            return m_data;
+        }
+
+        const_iterator end(
+
+        ) const
+        {
+            return m_data + m_size;
+        }
+
+        const_reverse_iterator rbegin(
+
+        ) const
+        {
+            return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator rend(
+
+        ) const
+        {
+            return const_reverse_iterator(begin());
+        }
+
+        std::size_t size(
+
+        ) const
+        {
+            return m_size;
+        }
+
+        bool empty(
+
+        ) const
+        {
+            return m_size == 0;
+        }
+
+        const T& operator[](
+            const std::size_t& a_index
+        ) const
+        {
+            return m_data[a_index];
+        }
+
+        std::size_t count(
+            const T& a_element
+        ) const
+        {
+            return std::binary_search(begin(), end(), a_element) ? 1 : 0;
+        }
+
+    private:
+        std::size_t m_size;
+        T*          m_data;
+
+        alignas(T) unsigned char m_inline[N * sizeof(T)];
+
+        T* inline_data(
+
+        )
+        {
+            return (T*)m_inline;
+        }
+
+        template<typename Iterator>
+        void assign(
+            Iterator a_begin,
+            const std::size_t& a_size
+        )
+        {
+            m_size = a_size;
+            m_data = a_size <= N ? inline_data() : (T*)arena::allocate(a_size * sizeof(T));
+
+            for (std::size_t i = 0; i < a_size; i++, a_begin++)
+                new (m_data + i) T(*a_begin);
+        }
+
+    };
+
+    // A fork-join pool of worker threads, each of which keeps a deque of jobs.
+    // Jobs forked by a thread are pushed onto the back of its own deque, and it
+    // pops them back off in LIFO order, while idle threads steal from the front
+    // of the others' deques. A thread waiting on its jobs runs other jobs in the
+    // meantime, so that nested forks never deadlock.
+    struct scheduler
+    {
+        // Runs every job, possibly in parallel, and returns once all are done.
+        // The first job runs on the calling thread. If any job throws, the first
+        // exception is rethrown here after the others have finished.
+        static void run(
+            const std::vector<std::function<void()>>& a_jobs
+        );
+
+        // Whether the calling thread reduces in parallel, that is, whether it is
+        // one of the workers, or is within a reduce(PARALLEL_EXPANSION) call.
+        static bool is_parallel(
+
+        );
+
+        static std::size_t thread_count(
+
+        );
+
+        // Restarts the pool with the given number of threads, counting the caller
+        // of run() as one of them. Zero picks the hardware concurrency. This must
+        // not be called while jobs are running.
+        static void set_thread_count(
+            const std::size_t& a_thread_count
+        );
+
+        // Marks the calling thread as reducing in parallel for its lifetime.
+        struct scope
+        {
+            bool m_previous;
+
+            ~scope(
+
+            );
+
+            scope(
+
+            );
+
+        };
+
+    private:
+        struct group
+        {
+            std::atomic<std::size_t> m_pending;
+            std::mutex               m_mutex;
+            std::exception_ptr       m_exception;
+        };
+
+        struct job
+        {
+            const std::function<void()>* m_work;
+            group*                       m_group;
+            // The arena of the forking thread, adopted while the job runs.
+            arena*                       m_arena;
+        };
+
+        struct worker_deque
+        {
+            std::deque<job> m_jobs;
+            std::mutex      m_mutex;
+        };
+
+        struct entries_type
+        {
+            // One deque per worker, and a last one shared by outside threads.
+            std::deque<worker_deque> m_deques;
+            std::vector<std::thread> m_threads;
+            std::size_t              m_thread_count = 0;
+            std::atomic<std::size_t> m_queued = 0;
+            std::mutex               m_mutex;
+            std::condition_variable  m_condition;
+            bool                     m_is_stopping = false;
+            bool                     m_is_started = false;
+        };
+
+        static entries_type& entries(
+
+        );
+
+        static void start(
+            entries_type& a_entries,
+            const std::size_t& a_thread_count
+        );
+
+        static void stop(
+            entries_type& a_entries
+        );
+
+        // Runs one queued job, preferring the calling thread's own deque.
+        // Returns whether there was a job to run.
+        static bool run_one(
+            entries_type& a_entries
+        );
+
+        static void execute(
+            const job& a_job
+        );
+
+    };
+
+    struct operand : public std::enable_shared_from_this<operand>
     {
         struct ptr : public std::shared_ptr<operand>
         {
+            ptr(
+                std::nullptr_t a_null
+            );
+
+            // Interns the operand, which the ptr (or the table) then owns.
             ptr(
                 operand* a_operand
             );
+
+            // Shares an operand which is already interned.
+            ptr(
+                const std::shared_ptr<operand>& a_operand
+            );
             
             bool operator<(
                 const ptr& a_operand
             ) const;
         };
 
+        // The operands of a product or sum. Most have only a handful.
+        typedef sorted_vector<ptr, 8> operand_list;
+
+        // Bindings of variable ids to the operands which replace them.
+        typedef std::unordered_map<std::size_t, ptr> substitutions;
+
         operand_types m_operand_type;
 
+        // Structural hash, node count and depth, computed once by the derived
+        // constructors. These serve as cheap keys to reject inequality early.
+        std::size_t   m_hash;
+        std::size_t   m_size;
+        std::size_t   m_depth;
+
+    protected:
+        // The sorted ids of the variables this operand depends upon.
+        std::vector<std::size_t> m_support;
+
     private:
-        bool          m_is_reduced;
+        // Set by the unique table while interning, before any other thread can
+        // see the operand. Nothing else about an operand changes once built.
+        bool          m_is_interned;
+
+        friend struct unique_table;
 
     public:
         virtual ~operand(
@@ -43,8 +556,40 @@ namespace ba_calculator
         operand(
             const operand_types& a_operand_type
         );
-        
+
+        static void* operator new(
+            std::size_t a_size
+        );
+
+        static void operator delete(
+            void* a_pointer
+        );
+
     protected:
+        // This operand's own canonical ptr. Every operand which escapes its
+        // constructor is owned by the unique table's shared_ptr.
+        ptr self(
+
+        ) const;
+
+        static std::size_t combine_hash(
+            const std::size_t& a_seed,
+            const std::size_t& a_value
+        );
+
+        void merge_support(
+            const operand& a_operand
+        );
+
+        // Reduces each of the operands. Under a parallel reduction, those of at
+        // least PARALLEL_REDUCE_THRESHOLD nodes are reduced as separate jobs.
+        static std::vector<ptr> reduce_each(
+            const operand_list& a_operands
+        );
+        
+    public:
+        static constexpr std::size_t PARALLEL_REDUCE_THRESHOLD = 64;
+
         virtual ptr reduce_operands(
 
         ) const;
@@ -57,14 +602,44 @@ namespace ba_calculator
 
         ) const;
 
-    public:
         ptr reduce(
 
         ) const;
 
-        virtual ptr substitute(
+        ptr reduce(
+            const reduction_strategies& a_strategy
+        ) const;
+
+        const std::vector<std::size_t>& support(
+
+        ) const;
+
+        // Whether any of the bound variables is in the support of this operand.
+        bool depends_on(
+            const substitutions& a_substitutions
+        ) const;
+
+        ptr substitute(
             const std::string& a_identifier,
             const ptr& a_operand
+        ) const;
+
+        ptr substitute(
+            const std::size_t& a_variable,
+            const ptr& a_operand
+        ) const;
+
+        // Binds the variable to the value, and folds away the constants which that
+        // leaves behind, so that the result no longer depends upon the variable.
+        ptr cofactor(
+            const std::size_t& a_variable,
+            const bool& a_value
+        ) const;
+
+        // Applies all of the bindings simultaneously in a single traversal.
+        // Subtrees which mention none of the bound variables are returned as-is.
+        virtual ptr substitute(
+            const substitutions& a_substitutions
         ) const = 0;
 
         virtual std::string to_string(
@@ -78,12 +653,161 @@ namespace ba_calculator
         bool operator==(
             const operand& a_operand
         ) const;
+
+        // Equality of this node's own payload, assuming that
+        // the children of both nodes are canonical (interned).
+        virtual bool shallow_equals(
+            const operand& a_operand
+        ) const = 0;
         
     };
+
+    // The unique table guarantees that at most one live instance of each
+    // structurally distinct operand exists. Every operand::ptr constructed
+    // from a raw operand is routed through it, so that structurally equal
+    // subterms are shared and can be compared by address.
+    struct unique_table
+    {
+        static std::shared_ptr<operand> intern(
+            operand* a_operand
+        );
+
+        static void erase(
+            const operand* a_operand
+        );
+
+        static std::size_t size(
+
+        );
+
+    private:
+        struct entry
+        {
+            const operand*         m_operand;
+            std::weak_ptr<operand> m_instance;
+        };
+
+        struct entries_type
+        {
+            std::unordered_multimap<std::size_t, entry> m_operands;
+
+            std::mutex m_mutex;
+        };
+
+        static entries_type& entries(
+
+        );
+
+    };
+    
+    // Memoizes operand::reduce() process-wide, so that a subterm recurring under
+    // different parents is only reduced once. Each result is cached as reducing
+    // to itself as well, so that reducing it again is a lookup rather than a
+    // pass. Entries are keyed by the structural hash and equality of the operand,
+    // and the least recently used entry is evicted once the capacity is exceeded.
+    // Cached operands are held strongly, so clear() is how their memory is given
+    // back. Entries made under an arena::scope are tagged with its arena, and
+    // dropped as the scope closes.
+    struct reduce_cache
+    {
+        // Returns a null ptr if the operand's reduction is not cached.
+        static operand::ptr find(
+            const operand::ptr& a_operand
+        );
+
+        static void insert(
+            const operand::ptr& a_operand,
+            const operand::ptr& a_result
+        );
+
+        static void clear(
+
+        );
+
+        static std::size_t size(
+
+        );
+
+        static std::size_t hits(
+
+        );
+
+        static std::size_t misses(
+
+        );
+
+        static std::size_t capacity(
+
+        );
+
+        // A capacity of zero disables the cache.
+        static void set_capacity(
+            const std::size_t& a_capacity
+        );
+
+        // Drops the entries made while the arena was current. The hit and miss
+        // counts are kept.
+        static void release(
+            const arena* a_arena
+        );
+
+    private:
+        struct entry
+        {
+            operand::ptr m_operand;
+            operand::ptr m_result;
+            const arena* m_arena;
+        };
+
+        struct hasher
+        {
+            std::size_t operator()(
+                const operand* a_operand
+            ) const;
+        };
+
+        struct equality
+        {
+            bool operator()(
+                const operand* a_operand_0,
+                const operand* a_operand_1
+            ) const;
+        };
+
+        struct entries_type
+        {
+            // Ordered from most to least recently used.
+            std::list<entry> m_recency;
+
+            std::unordered_map<
+                const operand*,
+                std::list<entry>::iterator,
+                hasher,
+                equality
+            > m_index;
+            
+            std::size_t m_capacity = 1 << 16;
+            std::size_t m_hits = 0;
+            std::size_t m_misses = 0;
+
+            std::mutex m_mutex;
+        };
+
+        static entries_type& entries(
+
+        );
+
+        // Drops the least recently used entries beyond the capacity. The caller
+        // holds the lock, and destroys the dropped entries once it releases it.
+        static std::list<entry> evict(
+
+        );
+
+    };
     
     struct unresolved : public operand
     {
-        std::string m_identifier;
+        std::size_t m_variable;
 
         virtual ~unresolved(
 
@@ -93,9 +817,12 @@ namespace ba_calculator
             const std::string& a_identifier
         );
 
+        unresolved(
+            const std::size_t& a_variable
+        );
+
         virtual ptr substitute(
-            const std::string& a_identifier,
-            const ptr& a_operand
+            const substitutions& a_substitutions
         ) const;
 
         virtual std::string to_string(
@@ -106,6 +833,10 @@ namespace ba_calculator
             const operand& a_operand
         ) const;
 
+        virtual bool shallow_equals(
+            const operand& a_operand
+        ) const;
+
     };
 
     struct resolved : public operand
@@ -121,8 +852,7 @@ namespace ba_calculator
         );
 
         virtual ptr substitute(
-            const std::string& a_identifier,
-            const ptr& a_operand
+            const substitutions& a_substitutions
         ) const;
 
         virtual std::string to_string(
@@ -132,6 +862,10 @@ namespace ba_calculator
         virtual bool operator<(
             const operand& a_operand
         ) const;
+
+        virtual bool shallow_equals(
+            const operand& a_operand
+        ) const;
         
     };
 
@@ -147,7 +881,6 @@ namespace ba_calculator
             const ptr& a_operand
         );
 
-    protected:
         virtual ptr reduce_operands(
 
         ) const;
@@ -160,10 +893,8 @@ namespace ba_calculator
 
         ) const;
 
-    public:
         virtual ptr substitute(
-            const std::string& a_identifier,
-            const ptr& a_operand
+            const substitutions& a_substitutions
         ) const;
 
         virtual std::string to_string(
@@ -173,24 +904,207 @@ namespace ba_calculator
         virtual bool operator<(
             const operand& a_operand
         ) const;
+
+        virtual bool shallow_equals(
+            const operand& a_operand
+        ) const;
         
     };
 
+    // A product of literals, packed as two bitmasks over variable indices: one
+    // for the variables appearing positively, and one for those appearing inverted.
+    struct cube
+    {
+        struct hasher
+        {
+            std::size_t operator()(
+                const cube& a_cube
+            ) const;
+        };
+
+        std::vector<std::uint64_t> m_positive;
+        std::vector<std::uint64_t> m_negative;
+
+        cube(
+            const std::size_t& a_variable_count
+        );
+
+        void insert(
+            const std::size_t& a_variable,
+            const bool& a_polarity
+        );
+
+        void erase(
+            const std::size_t& a_variable,
+            const bool& a_polarity
+        );
+
+        bool contains(
+            const std::size_t& a_variable,
+            const bool& a_polarity
+        ) const;
+
+        std::size_t literal_count(
+
+        ) const;
+
+        // Whether every literal of this cube is also in the given cube,
+        // meaning that the given cube is redundant alongside this one in a sum.
+        bool covers(
+            const cube& a_cube
+        ) const;
+
+        // Whether some variable appears in opposite polarities in the two cubes,
+        // meaning that their product is 0.
+        bool conflicts(
+            const cube& a_cube
+        ) const;
+
+        bool operator==(
+            const cube& a_cube
+        ) const;
+
+    };
+
+    // An index over a set of cubes for subsumption queries. Each cube is a path
+    // of its literals in ascending order, so a query only descends into the
+    // branches whose literals all appear in the queried cube, rather than
+    // visiting every indexed cube.
+    struct cube_trie
+    {
+        cube_trie(
+
+        );
+
+        void insert(
+            const cube& a_cube
+        );
+
+        // Whether some indexed cube covers the given cube.
+        bool covers(
+            const cube& a_cube
+        ) const;
+
+        // The number of distinct cubes indexed.
+        std::size_t size(
+
+        ) const;
+
+    private:
+        struct node
+        {
+            // Ordered by literal, pairing each literal with the index of its node.
+            std::vector<std::pair<std::size_t, std::size_t>> m_children;
+            bool                                               m_is_terminal = false;
+        };
+
+        std::vector<node> m_nodes;
+        std::size_t       m_size;
+
+        // The literals of the cube in ascending order, where the literal
+        // of a variable v is 2v when positive and 2v + 1 when inverted.
+        static std::vector<std::size_t> literals(
+            const cube& a_cube
+        );
+
+    };
+
+    // A sum of cubes, along with the variable id behind each cube index.
+    struct cover
+    {
+        std::vector<std::size_t> m_variables;
+        std::vector<cube>        m_cubes;
+
+        cover(
+            const std::vector<std::size_t>& a_variables
+        );
+
+        // Indexes the variables of the given products of literals.
+        cover(
+            const std::vector<operand::ptr>& a_products
+        );
+
+        // Reduces the operand into a sum of products, and indexes that.
+        static cover of(
+            const operand::ptr& a_operand
+        );
+
+        // An empty cube over this cover's variables.
+        cube make_cube(
+
+        ) const;
+
+        // Returns the same sum-of-products or resolved shape as operand::reduce().
+        operand::ptr to_operand(
+
+        ) const;
+
+        // Drops the cubes which are 0 or covered by another, and merges the cubes
+        // which differ only in the polarity of one variable, until neither applies.
+        void prune(
+
+        );
+
+        std::size_t literal_count(
+
+        ) const;
+
+    private:
+        static void remove_covered(
+            std::vector<cube>& a_cubes
+        );
+
+        // Replaces each pair of cubes which are opposites by their common part,
+        // returning whether any such pair was found.
+        static bool merge_opposites(
+            std::vector<cube>& a_cubes
+        );
+
+        // Whether the cubes hold the same literals, except for a single
+        // variable which appears in opposite polarities.
+        static bool are_opposites(
+            const cube& a_cube_0,
+            const cube& a_cube_1
+        );
+
+    };
+
     struct sum;
 
+    // The product of the two counts, or the largest std::size_t should it overflow.
+    // Estimates of distributions outgrow any count easily.
+    std::size_t saturating_multiply(
+        const std::size_t& a_value_0,
+        const std::size_t& a_value_1
+    );
+
+    // Thrown by product::expand() when distributing over its sums would build
+    // more products in a single step than product::distribution_budget() allows.
+    struct distribution_budget_exceeded : public std::runtime_error
+    {
+        // The number of products the offending step would have built.
+        std::size_t m_estimate;
+        std::size_t m_budget;
+
+        distribution_budget_exceeded(
+            const std::size_t& a_estimate,
+            const std::size_t& a_budget
+        );
+
+    };
+
     struct product : public operand
     {
-        std::set<ptr> m_operands;
+        operand_list m_operands;
 
         virtual ~product(
 
         );
 
         product(
-            const std::set<ptr>& a_operands
+            operand_list a_operands
         );
-        
-    protected:
+
         virtual ptr reduce_operands(
 
         ) const;
@@ -203,10 +1117,8 @@ namespace ba_calculator
 
         ) const;
 
-    public:
         virtual ptr substitute(
-            const std::string& a_identifier,
-            const ptr& a_substitution_operand
+            const substitutions& a_substitutions
         ) const;
 
         virtual std::string to_string(
@@ -216,28 +1128,74 @@ namespace ba_calculator
         virtual bool operator<(
             const operand& a_operand
         ) const;
+
+        virtual bool shallow_equals(
+            const operand& a_operand
+        ) const;
+
+        // The most products a single distribution step may build before
+        // product::expand() gives up. A budget of zero lifts the limit.
+        static std::size_t distribution_budget(
+
+        );
+
+        static void set_distribution_budget(
+            const std::size_t& a_budget
+        );
+
+        // The number of jobs a pair of sums is split into on the scheduler, once
+        // their cross product has at least PARALLEL_DISTRIBUTION_THRESHOLD
+        // products. Zero picks the scheduler's thread count, and one disables it.
+        static std::size_t distribution_thread_count(
+
+        );
+
+        static void set_distribution_thread_count(
+            const std::size_t& a_thread_count
+        );
+
+        static constexpr std::size_t PARALLEL_DISTRIBUTION_THRESHOLD = 1 << 12;
     
     private:
+        // May be changed while other threads reduce.
+        struct settings
+        {
+            std::atomic<std::size_t> m_budget = std::size_t(1) << 24;
+            std::atomic<std::size_t> m_thread_count = 0;
+        };
+
+        static settings& configuration(
+
+        );
+
         static ptr distribute(
             const sum& a_sum_0,
             const sum& a_sum_1
         );
 
+        // Distributes over packed cubes instead of operands, partitioning the
+        // products of the first sum across jobs. Each job collects its products
+        // locally, and the results are deduplicated once all are done.
+        static ptr distribute(
+            const sum& a_sum_0,
+            const sum& a_sum_1,
+            const std::size_t& a_thread_count
+        );
+
     };
 
     struct sum : public operand
     {
-        std::set<ptr> m_operands;
+        operand_list m_operands;
 
         virtual ~sum(
 
         );
 
         sum(
-            const std::set<ptr>& a_operands
+            operand_list a_operands
         );
-        
-    protected:
+
         virtual ptr reduce_operands(
 
         ) const;
@@ -250,10 +1208,8 @@ namespace ba_calculator
 
         ) const;
 
-    public:
         virtual ptr substitute(
-            const std::string& a_identifier,
-            const ptr& a_substitution_operand
+            const substitutions& a_substitutions
         ) const;
 
         virtual std::string to_string(
@@ -264,19 +1220,29 @@ namespace ba_calculator
             const operand& a_operand
         ) const;
 
-    private:
-        static bool covers(
-            const product& a_product_0,
-            const product& a_product_1
-        );
+        virtual bool shallow_equals(
+            const operand& a_operand
+        ) const;
 
-        static bool are_opposites(
-            const product& a_product_0,
-            const product& a_product_1
-        );
-        
     };
     
 }
 
+namespace std
+{
+    // Hashes an operand::ptr structurally. Since operands are interned, the
+    // default equality of operand::ptr (its address) is structural equality,
+    // so operand::ptr can key unordered containers directly.
+    template<>
+    struct hash<ba_calculator::operand::ptr>
+    {
+        std::size_t operator()(
+            const ba_calculator::operand::ptr& a_operand
+        ) const
+        {
+            return a_operand ? a_operand->m_hash : 0;
+        }
+    };
+}
+
 #endif
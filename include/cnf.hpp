@@ -0,0 +1,89 @@
+#ifndef CNF_HPP
+#define CNF_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "include/calculator.hpp"
+
+namespace ba_calculator
+{
+    // A product of clauses over DIMACS variables, which are numbered from 1. The
+    // first variables stand for the operand's support, in order, and any others
+    // are auxiliary variables introduced by the encoding.
+    struct cnf
+    {
+        // A DIMACS literal: the variable when positive, its inversion when negative.
+        typedef std::int32_t literal;
+
+        typedef std::vector<literal> clause;
+
+        // Operands up to this many nodes are distributed, and larger ones are encoded.
+        static constexpr std::size_t DISTRIBUTION_THRESHOLD = 32;
+
+        // The variable id behind each of the first DIMACS variables.
+        std::vector<std::size_t> m_variables;
+
+        std::size_t         m_variable_count;
+        std::vector<clause> m_clauses;
+
+        // Distributes small operands, and encodes the rest.
+        cnf(
+            const operand::ptr& a_operand
+        );
+
+        // Introduces a variable for each product and sum, constrained to equal
+        // it, so that the clauses are linear in the size of the operand. The
+        // result is satisfied by exactly the assignments satisfying the operand,
+        // extended by the values of the auxiliary variables.
+        static cnf tseitin(
+            const operand::ptr& a_operand
+        );
+
+        // Distributes sums over products, without auxiliary variables. The result
+        // is equivalent to the operand, but may be exponentially larger, and
+        // throws distribution_budget_exceeded as product::expand() does.
+        static cnf distribute(
+            const operand::ptr& a_operand
+        );
+
+        // The DIMACS variable of the given variable id, or 0 if it is not in the support.
+        literal variable(
+            const std::size_t& a_variable
+        ) const;
+
+        // Renders the clauses in the DIMACS format, preceded by
+        // a comment naming the identifier behind each variable.
+        std::string to_dimacs(
+
+        ) const;
+
+    private:
+        cnf(
+            const std::vector<std::size_t>& a_variables
+        );
+
+        literal make_variable(
+
+        );
+
+        // Returns a literal equal to the operand, adding the clauses defining it.
+        literal encode(
+            const operand& a_operand,
+            std::unordered_map<const operand*, literal>& a_encoded
+        );
+
+        // Adds clauses which hold exactly when the operand holds. Top-level
+        // products are split into their operands, rather than encoded.
+        void require(
+            const operand& a_operand,
+            std::unordered_map<const operand*, literal>& a_encoded
+        );
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef COUNTER_HPP
+#define COUNTER_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "include/calculator.hpp"
+
+namespace ba_calculator
+{
+    // An arbitrary-precision unsigned integer, as the model count of an operand
+    // over a few hundred variables is far beyond any machine word.
+    struct natural
+    {
+        // Little-endian base 2^32 digits, without any leading zero digits.
+        std::vector<std::uint32_t> m_digits;
+
+        natural(
+            const std::uint64_t& a_value = 0
+        );
+
+        static natural power_of_two(
+            const std::size_t& a_exponent
+        );
+
+        natural operator+(
+            const natural& a_natural
+        ) const;
+
+        // The given natural must be no greater than this one.
+        natural operator-(
+            const natural& a_natural
+        ) const;
+
+        natural operator*(
+            const natural& a_natural
+        ) const;
+
+        natural operator<<(
+            const std::size_t& a_shift
+        ) const;
+
+        bool operator==(
+            const natural& a_natural
+        ) const;
+
+        bool operator<(
+            const natural& a_natural
+        ) const;
+
+        // The decimal digits.
+        std::string to_string(
+
+        ) const;
+
+    private:
+        void trim(
+
+        );
+
+    };
+
+    // Counts the satisfying assignments of operands. Products and sums are split
+    // into operands over disjoint variables, whose counts combine arithmetically,
+    // and anything else is split on a variable into its two cofactors. Each
+    // operand met along the way is interned, so the count of every component is
+    // cached under its canonical ptr, and reused wherever it recurs.
+    struct model_counter
+    {
+        model_counter(
+
+        );
+
+        // The number of assignments to the operand's support which satisfy it.
+        natural count_models(
+            const operand::ptr& a_operand
+        );
+
+        std::size_t cache_size(
+
+        ) const;
+
+        std::size_t cache_hits(
+
+        ) const;
+
+    private:
+        std::unordered_map<operand::ptr, natural> m_cache;
+        std::size_t                               m_cache_hits;
+
+        // Splits the operands into groups over disjoint variables.
+        static std::vector<std::vector<operand::ptr>> components(
+            const operand::operand_list& a_operands
+        );
+
+        // The variable found in the supports of the most operands, preferring
+        // those which appear as literals among the operands or their operands.
+        static std::size_t branching_variable(
+            const operand::operand_list& a_operands
+        );
+
+        natural count_components(
+            const operand::ptr& a_operand,
+            const operand::operand_list& a_operands
+        );
+
+        natural count_cofactors(
+            const operand::ptr& a_operand,
+            const std::size_t& a_variable
+        );
+
+    };
+
+}
+
+#endif
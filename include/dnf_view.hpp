@@ -0,0 +1,138 @@
+#ifndef DNF_VIEW_HPP
+#define DNF_VIEW_HPP
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "include/calculator.hpp"
+
+namespace ba_calculator
+{
+    // A lazy sum of products view of an operand, which yields the products of
+    // its distribution one at a time instead of materializing them. Each product
+    // or sum of the operand becomes a cursor over its own products: sums run
+    // through their operands in turn, and products count through the products of
+    // their operands as an odometer. Inversions are pushed down to the literals.
+    // A product whose leading operands already conflict is skipped along with
+    // every combination of the operands after them, and a product with an
+    // operand which yields nothing at all is found to be empty straight away.
+    //
+    // The structure of each operand is described once, however often hash
+    // consing shares it, while cursors are only opened along the products being
+    // combined, and recycled once left behind. Memory thus follows the size of
+    // the operand as a graph, rather than the size of it unfolded into a tree.
+    //
+    // Products are yielded in distribution order. Neither duplicates nor covered
+    // products are removed, since that would need the others held in memory.
+    struct dnf_view
+    {
+        dnf_view(
+            const operand::ptr& a_operand
+        );
+
+        // Finds the next product of literals, returning false once there are none
+        // left. Where the operand holds unconditionally, as when it is 1, the
+        // product has no literals at all.
+        bool next(
+            operand::ptr& a_product
+        );
+
+        // Starts over from the first product.
+        void reset(
+
+        );
+
+    private:
+        enum cursor_kinds
+        {
+            LITERAL = 0,
+            CONSTANT = 1,
+            CONJUNCTION = 2,
+            DISJUNCTION = 3
+        };
+
+        // An operand under a polarity, shared by each of its occurrences.
+        struct shape
+        {
+            cursor_kinds m_kind;
+
+            // LITERAL: the literal, as 2v when positive and 2v + 1 when inverted.
+            // CONSTANT: the value.
+            std::size_t m_payload;
+
+            // The shapes of the operands.
+            std::vector<std::size_t> m_children;
+
+            // Whether the shape yields nothing whatever its operands' terms, as
+            // with 0, and products of any operand or sums of every operand which
+            // is empty too. Terms which conflict are only found while advancing.
+            bool m_is_empty;
+        };
+
+        // The iteration state of one occurrence of a shape.
+        struct cursor
+        {
+            std::size_t m_shape;
+
+            // The open cursors of the operands. CONJUNCTION: one per operand, once
+            // started. DISJUNCTION: the one being run through, if any.
+            std::vector<std::size_t> m_children;
+
+            // DISJUNCTION: the operand being run through. LITERAL, CONSTANT:
+            // whether the term was yielded. CONJUNCTION: whether it started.
+            std::size_t m_position;
+
+            // CONJUNCTION: the merged terms of the children up to each one.
+            std::vector<std::vector<std::size_t>> m_prefixes;
+
+            // The current term, as sorted literals.
+            std::vector<std::size_t> m_term;
+        };
+
+        operand::ptr        m_operand;
+        std::vector<shape>  m_shapes;
+        std::size_t         m_root;
+
+        // Cursors are recycled through the free list. A deque keeps references
+        // to them valid while others are opened.
+        std::deque<cursor>       m_cursors;
+        std::vector<std::size_t> m_free;
+
+        std::size_t build(
+            const operand& a_operand,
+            const bool& a_is_negated,
+            std::map<std::pair<const operand*, bool>, std::size_t>& a_shapes
+        );
+
+        std::size_t open(
+            const std::size_t& a_shape
+        );
+
+        // Closes the cursor, along with the cursors of its operands.
+        void close(
+            const std::size_t& a_cursor
+        );
+
+        bool advance(
+            const std::size_t& a_cursor
+        );
+
+        void reset(
+            const std::size_t& a_cursor
+        );
+
+        // Merges the sorted literals, returning false if they conflict.
+        static bool merge(
+            const std::vector<std::size_t>& a_literals_0,
+            const std::vector<std::size_t>& a_literals_1,
+            std::vector<std::size_t>& a_result
+        );
+
+    };
+
+}
+
+#endif
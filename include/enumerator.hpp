@@ -0,0 +1,73 @@
+#ifndef ENUMERATOR_HPP
+#define ENUMERATOR_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "include/calculator.hpp"
+
+namespace ba_calculator
+{
+    // Enumerates the satisfying assignments of an operand on demand, by a depth
+    // first search which binds the variables of its support in order. Only the
+    // cofactors along the current path are held, so memory is bounded by the
+    // size of the support however many assignments are found, and the caller
+    // may stop at any point.
+    struct enumerator
+    {
+        enumerator(
+            const operand::ptr& a_operand
+        );
+
+        // The variable id behind each cube index and assignment position.
+        const std::vector<std::size_t>& variables(
+
+        ) const;
+
+        // Finds the next cube of satisfying assignments, returning false once
+        // there are none left. The cubes are disjoint, and together cover every
+        // satisfying assignment. Variables absent from a cube may take either value.
+        bool next_cube(
+            cube& a_cube
+        );
+
+        // Finds the next satisfying assignment, by expanding each cube in turn.
+        // The value of variables()[i] is written to a_assignment[i].
+        bool next_assignment(
+            std::vector<bool>& a_assignment
+        );
+
+    private:
+        struct frame
+        {
+            operand::ptr m_operand;
+            // The index of the variable bound beneath this frame,
+            // and the value to bind it to next, until both are tried.
+            std::size_t  m_index;
+            std::size_t  m_next_value;
+        };
+
+        operand::ptr             m_operand;
+        std::vector<std::size_t> m_variables;
+        std::vector<frame>       m_frames;
+        bool                     m_is_started;
+
+        // The bindings along the current path.
+        cube m_path;
+
+        // The cube being expanded into assignments, the indices of its
+        // free variables, and the values they take in the current assignment.
+        cube                     m_cube;
+        std::vector<std::size_t> m_free;
+        std::vector<bool>        m_free_values;
+        bool                     m_has_cube;
+
+        void push(
+            const operand::ptr& a_operand
+        );
+
+    };
+
+}
+
+#endif
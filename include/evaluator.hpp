@@ -0,0 +1,83 @@
+#ifndef EVALUATOR_HPP
+#define EVALUATOR_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "include/calculator.hpp"
+
+namespace ba_calculator
+{
+    // An operand flattened into a linear program over 64-bit words, where each bit
+    // of a word is an independent truth assignment. Shared subterms are compiled
+    // once. Evaluating the program thus answers 64 assignments per word of input.
+    struct evaluator
+    {
+        enum opcodes
+        {
+            CONSTANT = 0,
+            LOAD = 1,
+            NOT = 2,
+            AND = 3,
+            OR = 4
+        };
+
+        // Every instruction writes to the register of its own index.
+        struct instruction
+        {
+            opcodes     m_opcode;
+
+            // CONSTANT: the value. LOAD: the index of the input.
+            // NOT: the source register. AND, OR: the range of argument
+            // registers, as indices into m_arguments.
+            std::size_t m_begin;
+            std::size_t m_end;
+        };
+
+        // The number of words processed together by each instruction. Each
+        // register holds this many words, laid out so that every instruction
+        // is a fixed-width loop the compiler may map onto vector registers.
+        static constexpr std::size_t LANES = 4;
+
+        // The variable id of each input, in order. This is the support of the operand.
+        std::vector<std::size_t> m_variables;
+
+        std::vector<instruction> m_instructions;
+        std::vector<std::size_t> m_arguments;
+
+        // LANES words per instruction, allocated once when compiled, so that
+        // evaluating never allocates. An evaluator thus evaluates on one thread
+        // at a time; copy it to evaluate on several.
+        std::vector<std::uint64_t> m_registers;
+
+        evaluator(
+            const operand::ptr& a_operand
+        );
+
+        // Evaluates 64 assignments. Bit j of a_inputs[i] is the value
+        // of variable m_variables[i] in assignment j.
+        std::uint64_t evaluate(
+            const std::vector<std::uint64_t>& a_inputs
+        );
+
+        // Evaluates 64 * a_word_count assignments. Word w of input i is found
+        // at a_inputs[i * a_word_count + w], and the results are written to
+        // a_outputs[w].
+        void evaluate(
+            const std::uint64_t* a_inputs,
+            const std::size_t& a_word_count,
+            std::uint64_t* a_outputs
+        );
+
+    private:
+        std::size_t compile(
+            const operand& a_operand,
+            std::unordered_map<const operand*, std::size_t>& a_registers
+        );
+
+    };
+
+}
+
+#endif
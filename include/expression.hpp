@@ -0,0 +1,121 @@
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "include/calculator.hpp"
+
+namespace ba_calculator
+{
+    // An operand flattened into an array of tagged nodes, each holding its type
+    // and its payload inline. Every traversal switches on the tag of the node
+    // rather than calling through a vtable, so the compiler is free to inline
+    // the recursion in comparison and reduction. Shared subterms are compiled once.
+    struct expression
+    {
+        typedef std::uint32_t node;
+
+        struct node_entry
+        {
+            operand_types m_type;
+
+            // UNRESOLVED: the variable id. RESOLVED: the value. INVERT: the
+            // child node. PRODUCT, SUM: the range of child nodes, as indices
+            // into m_children, ordered as the operand orders its operands.
+            std::uint32_t m_begin;
+            std::uint32_t m_end;
+
+            // The node count of the subterm, as operand::m_size.
+            std::uint32_t m_size;
+        };
+
+        std::vector<node_entry> m_nodes;
+        std::vector<node>       m_children;
+        node                    m_root;
+
+        expression(
+            const operand::ptr& a_operand
+        );
+
+        operand::ptr to_operand(
+
+        ) const;
+
+        // Renders the same string as operand::to_string().
+        std::string to_string(
+
+        ) const;
+
+        // Applies all of the bindings simultaneously, as operand::substitute() does.
+        expression substitute(
+            const operand::substitutions& a_substitutions
+        ) const;
+
+        // Orders expressions as operand::operator<() orders their operands.
+        bool operator<(
+            const expression& a_expression
+        ) const;
+
+        // Expands into an equivalent sum of products, pruning covered and opposite
+        // products at every node along the way. Unlike operand::reduce(), the
+        // result is always a sum of products or a constant, so a lone literal a
+        // comes back as ((a && ) || ), and the pruned cover may differ as well.
+        operand::ptr reduce(
+
+        ) const;
+
+    private:
+        expression(
+
+        );
+
+        node compile(
+            const operand& a_operand,
+            std::unordered_map<const operand*, node>& a_compiled
+        );
+
+        // Appends a node of the given type over the given children, which
+        // are sorted and deduplicated as the operand's operands would be.
+        node append(
+            const operand_types& a_type,
+            std::vector<node> a_children
+        );
+
+        node substitute(
+            const expression& a_expression,
+            const node& a_node,
+            const operand::substitutions& a_substitutions,
+            std::vector<node>& a_substituted,
+            std::unordered_map<const operand*, node>& a_compiled
+        );
+
+        // Three-way comparison, in the order of operand::operator<().
+        static int compare(
+            const expression& a_expression_0,
+            const node& a_node_0,
+            const expression& a_expression_1,
+            const node& a_node_1
+        );
+
+        void to_string(
+            const node& a_node,
+            std::string& a_result
+        ) const;
+
+        // The pruned cubes of the node, or of its negation, over the cover's
+        // variables. Negations are pushed down to the literals as it goes.
+        const std::vector<cube>& expand(
+            const node& a_node,
+            const bool& a_is_negated,
+            cover& a_cover,
+            std::unordered_map<std::size_t, std::vector<cube>>& a_expanded
+        ) const;
+
+    };
+
+}
+
+#endif
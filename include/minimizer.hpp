@@ -0,0 +1,123 @@
+#ifndef MINIMIZER_HPP
+#define MINIMIZER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "include/calculator.hpp"
+
+namespace ba_calculator
+{
+    // Two-level minimization of the sum of products which reduce() produces.
+    struct minimizer
+    {
+        // Espresso-style minimization. The reduced cover is first expanded into
+        // prime implicants and made irredundant, and then repeatedly reduced,
+        // re-expanded and made irredundant again for as long as that keeps
+        // shrinking it. The result is a near-minimal cover of the same function.
+        static operand::ptr heuristic(
+            const operand::ptr& a_operand
+        );
+
+        static cover heuristic(
+            const cover& a_cover
+        );
+
+        // Quine-McCluskey minimization, which yields a cover with the fewest
+        // products (and the fewest literals among those). Prime implicants are
+        // found by combining implicants from adjacent popcount groups, with the
+        // pairs of groups split into a_thread_count jobs on the scheduler (zero
+        // picks its thread count). The cover is then selected by branch and bound.
+        // The minterms are enumerated, so this is limited to MAX_EXACT_VARIABLES.
+        static operand::ptr exact(
+            const operand::ptr& a_operand,
+            const std::size_t& a_thread_count = 0
+        );
+
+        static cover exact(
+            const cover& a_cover,
+            const std::size_t& a_thread_count = 0
+        );
+
+        static constexpr std::size_t MAX_EXACT_VARIABLES = 20;
+
+        // Whether the sum of the given cubes is 1.
+        static bool is_tautology(
+            const std::vector<cube>& a_cubes
+        );
+
+        // Whether the cube implies the sum of the given cubes.
+        static bool is_covered(
+            const std::vector<cube>& a_cubes,
+            const cube& a_cube
+        );
+
+    private:
+        // A cube over at most 64 variables. The bits of m_mask are the variables
+        // which appear, and the bits of m_value are their polarities.
+        struct implicant
+        {
+            std::uint64_t m_value;
+            std::uint64_t m_mask;
+
+            bool operator<(
+                const implicant& a_implicant
+            ) const;
+
+            bool operator==(
+                const implicant& a_implicant
+            ) const;
+        };
+
+        static std::vector<implicant> prime_implicants(
+            const std::vector<implicant>& a_minterms,
+            const std::size_t& a_thread_count
+        );
+
+        static std::vector<implicant> select_cover(
+            const std::vector<implicant>& a_primes,
+            const std::vector<implicant>& a_minterms
+        );
+
+        static void select_cover(
+            const std::vector<implicant>& a_primes,
+            const std::vector<std::vector<std::size_t>>& a_primes_of_minterm,
+            const std::vector<std::vector<std::size_t>>& a_minterms_of_prime,
+            std::vector<std::size_t>& a_times_covered,
+            std::vector<std::size_t>& a_chosen,
+            std::vector<std::size_t>& a_best,
+            std::size_t& a_best_literals
+        );
+
+        // The cubes which agree with the given cube, with its literals removed.
+        static std::vector<cube> cofactor(
+            const std::vector<cube>& a_cubes,
+            const cube& a_cube
+        );
+
+        // Raises each cube to a prime implicant, and drops the cubes it then covers.
+        static void expand(
+            cover& a_cover
+        );
+
+        // Drops cubes which the rest of the cover already implies.
+        static void irredundant(
+            cover& a_cover
+        );
+
+        // Lowers each cube to the smallest cube which the rest of the cover does
+        // not already imply, making room for the next expansion to find other primes.
+        static void reduce(
+            cover& a_cover
+        );
+
+        static bool is_cheaper(
+            const cover& a_cover_0,
+            const cover& a_cover_1
+        );
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef SOLVER_HPP
+#define SOLVER_HPP
+
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "include/calculator.hpp"
+#include "include/cnf.hpp"
+
+namespace ba_calculator
+{
+    // A conflict-driven clause learning satisfiability solver over the clauses
+    // of a cnf. Each clause is watched by two of its literals, so propagation
+    // only visits the clauses of a literal once it becomes false. Every conflict
+    // is analyzed down to its first unique implication point, and the learnt
+    // clause sends the search back to the level at which it becomes unit.
+    // Searches restart on the Luby sequence, keeping the saved phases.
+    struct solver
+    {
+        typedef cnf::literal literal;
+
+        // The number of conflicts in the unit of the restart sequence.
+        static constexpr std::size_t RESTART_INTERVAL = 100;
+
+        solver(
+            const cnf& a_cnf
+        );
+
+        // Clauses may be added between searches, as when blocking a model.
+        void add_clause(
+            const cnf::clause& a_clause
+        );
+
+        bool solve(
+
+        );
+
+        // The value of the DIMACS variable in the model of the last successful search.
+        bool value(
+            const literal& a_variable
+        ) const;
+
+        std::size_t variable_count(
+
+        ) const;
+
+        std::size_t conflict_count(
+
+        ) const;
+
+        // These encode the operands through cnf::tseitin(), so never expand them.
+        static bool is_satisfiable(
+            const operand::ptr& a_operand
+        );
+
+        static bool is_tautology(
+            const operand::ptr& a_operand
+        );
+
+        static bool equivalent(
+            const operand::ptr& a_operand_0,
+            const operand::ptr& a_operand_1
+        );
+
+    private:
+        // A literal as 2 (v - 1), plus 1 when inverted, so that it indexes arrays directly.
+        typedef std::uint32_t code;
+
+        static constexpr std::size_t NO_CLAUSE = std::size_t(-1);
+
+        struct variable_state
+        {
+            // -1 while unassigned.
+            std::int8_t m_value;
+            bool        m_phase;
+            bool        m_is_seen;
+            std::size_t m_level;
+            // The clause which implied the value, or NO_CLAUSE for decisions.
+            std::size_t m_reason;
+            double      m_activity;
+        };
+
+        std::vector<std::vector<code>>        m_clauses;
+        std::vector<std::vector<std::size_t>> m_watches;
+        std::vector<variable_state>           m_variables;
+        std::vector<bool>                     m_model;
+
+        // The assigned literals in order, and where each decision level begins.
+        std::vector<code>        m_trail;
+        std::vector<std::size_t> m_trail_limits;
+        std::size_t              m_propagated;
+
+        // Unassigned variables by activity. Entries are left behind when a
+        // variable is bumped or assigned, and are skipped once popped.
+        std::priority_queue<std::pair<double, std::size_t>> m_order;
+        double                                            m_increment;
+
+        bool        m_is_inconsistent;
+        std::size_t m_conflicts;
+
+        static code encode(
+            const literal& a_literal
+        );
+
+        // 1 if true, 0 if false, and -1 if unassigned.
+        int value(
+            const code& a_code
+        ) const;
+
+        void assign(
+            const code& a_code,
+            const std::size_t& a_reason
+        );
+
+        void attach(
+            std::vector<code> a_clause
+        );
+
+        // Returns the clause found to be false, or NO_CLAUSE.
+        std::size_t propagate(
+
+        );
+
+        // Learns the clause asserting the first unique implication point of the
+        // conflict, with that literal first and one of the backjump level second.
+        std::vector<code> analyze(
+            const std::size_t& a_conflict
+        );
+
+        void backtrack(
+            const std::size_t& a_level
+        );
+
+        void bump(
+            const std::size_t& a_variable
+        );
+
+        // Returns false once every variable is assigned.
+        bool decide(
+
+        );
+
+        static std::size_t luby(
+            std::size_t a_index
+        );
+
+    };
+
+}
+
+#endif
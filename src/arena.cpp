@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/calculator.hpp"
+
+using namespace ba_calculator;
+
+namespace
+{
+    // Every block is preceded by a header recording the arena it was carved
+    // from (null for the global heap) and its size. The header is padded
+    // out to the maximum alignment so that the block itself stays aligned.
+    struct block_header
+    {
+        arena*      m_arena;
+        std::size_t m_size;
+    };
+
+    constexpr std::size_t HEADER_SIZE =
+        (sizeof(block_header) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    std::size_t align_up(
+        const std::size_t& a_size
+    )
+    {
+        return (a_size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    }
+
+    thread_local arena* s_current_arena = nullptr;
+
+}
+
+arena::scope::~scope(
+
+)
+{
+    s_current_arena = m_previous;
+
+    // Cached reductions made under the scope would otherwise hold its slabs.
+    reduce_cache::release(m_arena);
+
+    bool l_is_empty;
+
+    {
+        std::lock_guard<std::mutex> l_lock(m_arena->m_mutex);
+        m_arena->m_is_open = false;
+        l_is_empty = m_arena->m_live_allocations == 0;
+    }
+
+    if (l_is_empty)
+        // Nothing escaped the scope, release the slabs right away.
+        delete m_arena;
+
+}
+
+arena::scope::scope(
+    const std::size_t& a_slab_size
+) :
+    m_arena(new arena(a_slab_size)),
+    m_previous(s_current_arena)
+{
+    s_current_arena = m_arena;
+}
+
+arena::adoption::~adoption(
+
+)
+{
+    s_current_arena = m_previous;
+}
+
+arena::adoption::adoption(
+    arena* a_arena
+) :
+    m_previous(s_current_arena)
+{
+    s_current_arena = a_arena;
+}
+
+arena::~arena(
+
+)
+{
+    for (char* l_slab : m_slabs)
+        ::operator delete(l_slab);
+}
+
+arena::arena(
+    const std::size_t& a_slab_size
+) :
+    m_slab_size(a_slab_size),
+    m_offset(a_slab_size),
+    m_live_allocations(0),
+    m_is_open(true)
+{
+
+}
+
+void* arena::allocate(
+    const std::size_t& a_size
+)
+{
+    std::size_t l_block_size = HEADER_SIZE + align_up(a_size);
+
+    arena* l_arena = s_current_arena;
+
+    char* l_block = l_arena != nullptr ?
+        (char*)l_arena->bump(l_block_size) :
+        (char*)::operator new(l_block_size);
+
+    block_header* l_header = (block_header*)l_block;
+    l_header->m_arena = l_arena;
+    l_header->m_size = l_block_size;
+
+    return l_block + HEADER_SIZE;
+
+}
+
+void arena::deallocate(
+    void* a_pointer
+)
+{
+    if (a_pointer == nullptr)
+        return;
+
+    char* l_block = (char*)a_pointer - HEADER_SIZE;
+
+    block_header* l_header = (block_header*)l_block;
+
+    if (l_header->m_arena == nullptr)
+    {
+        ::operator delete(l_block);
+        return;
+    }
+
+    l_header->m_arena->release(l_block, l_header->m_size);
+
+}
+
+arena* arena::current(
+
+)
+{
+    return s_current_arena;
+}
+
+void* arena::bump(
+    const std::size_t& a_size
+)
+{
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+
+    if (a_size > m_slab_size)
+    {
+        // Oversized blocks get a slab of their own, which is slotted in behind
+        // the active slab so that bumping can continue where it left off.
+        char* l_slab = (char*)::operator new(a_size);
+        m_slabs.insert(m_slabs.empty() ? m_slabs.end() : std::prev(m_slabs.end()), l_slab);
+        m_live_allocations++;
+        return l_slab;
+    }
+
+    if (m_offset + a_size > m_slab_size)
+    {
+        // The active slab is exhausted, start a new one.
+        m_slabs.push_back((char*)::operator new(m_slab_size));
+        m_offset = 0;
+    }
+
+    char* l_result = m_slabs.back() + m_offset;
+
+    m_offset += a_size;
+    m_live_allocations++;
+
+    return l_result;
+
+}
+
+void arena::release(
+    char* a_block,
+    const std::size_t& a_size
+)
+{
+    bool l_is_released;
+
+    {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+
+        if (!m_slabs.empty() && a_block + a_size == m_slabs.back() + m_offset)
+            // The most recent block may be handed back to the slab. This is the common
+            // case for duplicates which the unique table discards right after creation.
+            m_offset -= a_size;
+
+        m_live_allocations--;
+
+        l_is_released = m_live_allocations == 0 && !m_is_open;
+    }
+
+    if (l_is_released)
+        delete this;
+
+}
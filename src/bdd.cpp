@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <assert.h>
+
+#include "include/bdd.hpp"
+
+using namespace ba_calculator;
+
+namespace
+{
+    // The terminals sit below every variable in the order.
+    const std::size_t TERMINAL_LEVEL = std::numeric_limits<std::size_t>::max();
+}
+
+bdd_manager::bdd_manager(
+
+) :
+    bdd_manager(std::vector<std::size_t>())
+{
+
+}
+
+bdd_manager::bdd_manager(
+    const std::vector<std::size_t>& a_order
+) :
+    m_nodes({
+        { TERMINAL_LEVEL, FALSE_NODE, FALSE_NODE },
+        { TERMINAL_LEVEL, TRUE_NODE, TRUE_NODE }
+    })
+{
+    for (const std::size_t& l_variable : a_order)
+        level(l_variable);
+}
+
+std::vector<std::size_t> bdd_manager::depth_first_order(
+    const operand::ptr& a_operand
+)
+{
+    std::vector<std::size_t> l_result;
+    std::unordered_map<std::size_t, bool> l_seen;
+    std::vector<const operand*> l_stack = { a_operand.get() };
+
+    while (!l_stack.empty())
+    {
+        const operand* l_operand = l_stack.back();
+        l_stack.pop_back();
+
+        switch(l_operand->m_operand_type)
+        {
+            case UNRESOLVED:
+            {
+                std::size_t l_variable = ((const unresolved*)l_operand)->m_variable;
+
+                if (l_seen.insert({l_variable, true}).second)
+                    l_result.push_back(l_variable);
+
+                break;
+            }
+            case INVERT:
+            {
+                l_stack.push_back(((const invert*)l_operand)->m_operand.get());
+                break;
+            }
+            case PRODUCT:
+            case SUM:
+            {
+                const operand::operand_list& l_operands = l_operand->m_operand_type == PRODUCT ?
+                    ((const product*)l_operand)->m_operands :
+                    ((const sum*)l_operand)->m_operands;
+
+                // Push in reverse, so that the first child is visited first.
+                for (auto l_it = l_operands.rbegin(); l_it != l_operands.rend(); std::advance(l_it, 1))
+                    l_stack.push_back(l_it->get());
+
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+        
+    }
+
+    return l_result;
+    
+}
+
+bdd_manager::node bdd_manager::variable(
+    const std::size_t& a_variable
+)
+{
+    return make(level(a_variable), FALSE_NODE, TRUE_NODE);
+}
+
+bdd_manager::node bdd_manager::ite(
+    const node& a_if,
+    const node& a_then,
+    const node& a_else
+)
+{
+    // Terminal cases.
+    if (a_if == TRUE_NODE)
+        return a_then;
+    if (a_if == FALSE_NODE)
+        return a_else;
+    if (a_then == a_else)
+        return a_then;
+    if (a_then == TRUE_NODE && a_else == FALSE_NODE)
+        return a_if;
+
+    triple l_key = { a_if, a_then, a_else };
+
+    auto l_it = m_computed.find(l_key);
+
+    if (l_it != m_computed.end())
+        return l_it->second;
+
+    // Split on the top-most variable among the three operands.
+    std::size_t l_level = std::min({
+        m_nodes[a_if].m_level,
+        m_nodes[a_then].m_level,
+        m_nodes[a_else].m_level
+    });
+
+    node l_if_low, l_if_high, l_then_low, l_then_high, l_else_low, l_else_high;
+
+    cofactor(a_if, l_level, l_if_low, l_if_high);
+    cofactor(a_then, l_level, l_then_low, l_then_high);
+    cofactor(a_else, l_level, l_else_low, l_else_high);
+
+    node l_high = ite(l_if_high, l_then_high, l_else_high);
+    node l_low = ite(l_if_low, l_then_low, l_else_low);
+
+    node l_result = make(l_level, l_low, l_high);
+
+    m_computed.insert({l_key, l_result});
+
+    return l_result;
+    
+}
+
+bdd_manager::node bdd_manager::negate(
+    const node& a_node
+)
+{
+    return ite(a_node, FALSE_NODE, TRUE_NODE);
+}
+
+bdd_manager::node bdd_manager::conjoin(
+    const node& a_node_0,
+    const node& a_node_1
+)
+{
+    return ite(a_node_0, a_node_1, FALSE_NODE);
+}
+
+bdd_manager::node bdd_manager::disjoin(
+    const node& a_node_0,
+    const node& a_node_1
+)
+{
+    return ite(a_node_0, TRUE_NODE, a_node_1);
+}
+
+bdd_manager::node bdd_manager::build(
+    const operand::ptr& a_operand
+)
+{
+    std::unordered_map<const operand*, node> l_built;
+    return build(*a_operand, l_built);
+}
+
+operand::ptr bdd_manager::to_operand(
+    const node& a_node
+) const
+{
+    if (a_node == FALSE_NODE)
+        return operand::ptr(new resolved(0));
+
+    if (a_node == TRUE_NODE)
+        return operand::ptr(new resolved(1));
+
+    std::map<std::size_t, bool> l_path;
+    std::vector<std::map<std::size_t, bool>> l_paths;
+
+    collect_paths(a_node, l_path, l_paths);
+
+    std::vector<operand::ptr> l_products;
+
+    for (std::map<std::size_t, bool>& l_cube : l_paths)
+    {
+        // Drop each literal which the function does not need, leaving a prime implicant.
+        for (auto l_it = l_cube.begin(); l_it != l_cube.end();)
+        {
+            std::pair<std::size_t, bool> l_literal = *l_it;
+
+            l_it = l_cube.erase(l_it);
+
+            std::unordered_map<node, bool> l_implied;
+
+            if (!implies(l_cube, a_node, l_implied))
+                l_it = std::next(l_cube.insert(l_literal).first);
+        }
+
+        std::vector<operand::ptr> l_literals;
+
+        for (const std::pair<const std::size_t, bool>& l_literal : l_cube)
+        {
+            operand::ptr l_variable(new unresolved(m_order[l_literal.first]));
+
+            l_literals.push_back(l_literal.second ? l_variable : operand::ptr(new invert(l_variable)));
+        }
+
+        l_products.push_back(operand::ptr(new product(std::move(l_literals))));
+    }
+
+    // Paths widened into the same prime, or into primes which cover each other, are pruned.
+    cover l_cover(l_products);
+
+    l_cover.prune();
+
+    return l_cover.to_operand();
+    
+}
+
+bool bdd_manager::equivalent(
+    const operand::ptr& a_operand_0,
+    const operand::ptr& a_operand_1
+)
+{
+    // Both functions are canonical under the same order.
+    return build(a_operand_0) == build(a_operand_1);
+}
+
+bool bdd_manager::is_satisfiable(
+    const operand::ptr& a_operand
+)
+{
+    return build(a_operand) != FALSE_NODE;
+}
+
+bool bdd_manager::is_tautology(
+    const operand::ptr& a_operand
+)
+{
+    return build(a_operand) == TRUE_NODE;
+}
+
+std::size_t bdd_manager::size(
+
+) const
+{
+    return m_nodes.size();
+}
+
+bool bdd_manager::triple::operator==(
+    const triple& a_triple
+) const
+{
+    return m_0 == a_triple.m_0 && m_1 == a_triple.m_1 && m_2 == a_triple.m_2;
+}
+
+std::size_t bdd_manager::triple_hasher::operator()(
+    const triple& a_triple
+) const
+{
+    std::size_t l_result = a_triple.m_0;
+    l_result = l_result * 0x9e3779b97f4a7c15ULL + a_triple.m_1;
+    l_result = l_result * 0x9e3779b97f4a7c15ULL + a_triple.m_2;
+    return l_result ^ (l_result >> 29);
+}
+
+std::size_t bdd_manager::level(
+    const std::size_t& a_variable
+)
+{
+    auto l_inserted = m_levels.insert({a_variable, m_order.size()});
+
+    if (l_inserted.second)
+        // The variable was not yet ordered, place it beneath all others.
+        m_order.push_back(a_variable);
+
+    return l_inserted.first->second;
+    
+}
+
+bdd_manager::node bdd_manager::make(
+    const std::size_t& a_level,
+    const node& a_low,
+    const node& a_high
+)
+{
+    if (a_low == a_high)
+        // The variable has no influence, skip the test entirely.
+        return a_low;
+
+    triple l_key = { a_level, a_low, a_high };
+
+    auto l_it = m_unique.find(l_key);
+
+    if (l_it != m_unique.end())
+        return l_it->second;
+
+    node l_result = (node)m_nodes.size();
+
+    m_nodes.push_back({ a_level, a_low, a_high });
+    m_unique.insert({l_key, l_result});
+
+    return l_result;
+    
+}
+
+void bdd_manager::cofactor(
+    const node& a_node,
+    const std::size_t& a_level,
+    node& a_low,
+    node& a_high
+) const
+{
+    const node_entry& l_entry = m_nodes[a_node];
+
+    if (l_entry.m_level != a_level)
+    {
+        // The node does not test this variable, so it is its own cofactor.
+        a_low = a_node;
+        a_high = a_node;
+        return;
+    }
+
+    a_low = l_entry.m_low;
+    a_high = l_entry.m_high;
+    
+}
+
+bdd_manager::node bdd_manager::build(
+    const operand& a_operand,
+    std::unordered_map<const operand*, node>& a_built
+)
+{
+    auto l_it = a_built.find(&a_operand);
+
+    if (l_it != a_built.end())
+        // Interned subterms shared within the tree are built once.
+        return l_it->second;
+
+    node l_result;
+
+    switch(a_operand.m_operand_type)
+    {
+        case UNRESOLVED:
+        {
+            l_result = variable(((const unresolved&)a_operand).m_variable);
+            break;
+        }
+        case RESOLVED:
+        {
+            l_result = ((const resolved&)a_operand).m_value ? TRUE_NODE : FALSE_NODE;
+            break;
+        }
+        case INVERT:
+        {
+            l_result = negate(build(*((const invert&)a_operand).m_operand, a_built));
+            break;
+        }
+        case PRODUCT:
+        {
+            l_result = TRUE_NODE;
+
+            for (const operand::ptr& l_operand : ((const product&)a_operand).m_operands)
+            {
+                l_result = conjoin(l_result, build(*l_operand, a_built));
+
+                if (l_result == FALSE_NODE)
+                    // Annihilated, the remaining operands cannot matter.
+                    break;
+            }
+
+            break;
+        }
+        case SUM:
+        {
+            l_result = FALSE_NODE;
+
+            for (const operand::ptr& l_operand : ((const sum&)a_operand).m_operands)
+            {
+                l_result = disjoin(l_result, build(*l_operand, a_built));
+
+                if (l_result == TRUE_NODE)
+                    // Annihilated, the remaining operands cannot matter.
+                    break;
+            }
+
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown operand type in bdd_manager::build()");
+        }
+    }
+
+    a_built.insert({&a_operand, l_result});
+
+    return l_result;
+    
+}
+
+void bdd_manager::collect_paths(
+    const node& a_node,
+    std::map<std::size_t, bool>& a_path,
+    std::vector<std::map<std::size_t, bool>>& a_paths
+) const
+{
+    if (a_node == FALSE_NODE)
+        return;
+
+    if (a_node == TRUE_NODE)
+    {
+        a_paths.push_back(a_path);
+        return;
+    }
+
+    const node_entry& l_entry = m_nodes[a_node];
+
+    a_path[l_entry.m_level] = false;
+    collect_paths(l_entry.m_low, a_path, a_paths);
+
+    a_path[l_entry.m_level] = true;
+    collect_paths(l_entry.m_high, a_path, a_paths);
+
+    a_path.erase(l_entry.m_level);
+    
+}
+
+bool bdd_manager::implies(
+    const std::map<std::size_t, bool>& a_cube,
+    const node& a_node,
+    std::unordered_map<node, bool>& a_implied
+) const
+{
+    if (a_node == FALSE_NODE || a_node == TRUE_NODE)
+        return a_node == TRUE_NODE;
+
+    auto l_it = a_implied.find(a_node);
+
+    if (l_it != a_implied.end())
+        return l_it->second;
+
+    const node_entry& l_entry = m_nodes[a_node];
+
+    auto l_literal = a_cube.find(l_entry.m_level);
+
+    bool l_result;
+
+    if (l_literal != a_cube.end())
+        l_result = implies(a_cube, l_literal->second ? l_entry.m_high : l_entry.m_low, a_implied);
+    else
+        // The cube leaves the variable free, so both branches must hold.
+        l_result = implies(a_cube, l_entry.m_low, a_implied) && implies(a_cube, l_entry.m_high, a_implied);
+
+    a_implied.insert({a_node, l_result});
+
+    return l_result;
+    
+}
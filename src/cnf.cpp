@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/cnf.hpp"
+
+using namespace ba_calculator;
+
+cnf::cnf(
+    const std::vector<std::size_t>& a_variables
+) :
+    m_variables(a_variables),
+    m_variable_count(a_variables.size())
+{
+
+}
+
+cnf::cnf(
+    const operand::ptr& a_operand
+) :
+    cnf(a_operand->support())
+{
+    if (a_operand->m_size <= DISTRIBUTION_THRESHOLD)
+    {
+        try
+        {
+            *this = distribute(a_operand);
+            return;
+        }
+        catch (const distribution_budget_exceeded&)
+        {
+            // Fall back onto the encoding, which never blows up.
+        }
+    }
+
+    *this = tseitin(a_operand);
+
+}
+
+cnf cnf::tseitin(
+    const operand::ptr& a_operand
+)
+{
+    cnf l_result(a_operand->support());
+
+    std::unordered_map<const operand*, literal> l_encoded;
+
+    l_result.require(*a_operand, l_encoded);
+
+    return l_result;
+
+}
+
+cnf cnf::distribute(
+    const operand::ptr& a_operand
+)
+{
+    cnf l_result(a_operand->support());
+
+    // The clauses of the operand are the inverted cubes of its inversion.
+    cover l_cover = cover::of(operand::ptr(new invert(a_operand)));
+
+    for (const cube& l_cube : l_cover.m_cubes)
+    {
+        clause l_clause;
+
+        for (std::size_t i = 0; i < l_cover.m_variables.size(); i++)
+        {
+            if (l_cube.contains(i, true))
+                l_clause.push_back(-l_result.variable(l_cover.m_variables[i]));
+            else if (l_cube.contains(i, false))
+                l_clause.push_back(l_result.variable(l_cover.m_variables[i]));
+        }
+
+        l_result.m_clauses.push_back(l_clause);
+
+    }
+
+    return l_result;
+
+}
+
+cnf::literal cnf::variable(
+    const std::size_t& a_variable
+) const
+{
+    auto l_it = std::lower_bound(m_variables.begin(), m_variables.end(), a_variable);
+
+    if (l_it == m_variables.end() || *l_it != a_variable)
+        return 0;
+
+    return literal(l_it - m_variables.begin()) + 1;
+
+}
+
+std::string cnf::to_dimacs(
+
+) const
+{
+    std::stringstream l_result_ss;
+
+    for (std::size_t i = 0; i < m_variables.size(); i++)
+        l_result_ss << "c " << i + 1 << " " << symbol_table::identifier(m_variables[i]) << "\n";
+
+    l_result_ss << "p cnf " << m_variable_count << " " << m_clauses.size() << "\n";
+
+    for (const clause& l_clause : m_clauses)
+    {
+        for (const literal& l_literal : l_clause)
+            l_result_ss << l_literal << " ";
+
+        l_result_ss << "0\n";
+    }
+
+    return l_result_ss.str();
+
+}
+
+cnf::literal cnf::make_variable(
+
+)
+{
+    m_variable_count++;
+    return literal(m_variable_count);
+}
+
+cnf::literal cnf::encode(
+    const operand& a_operand,
+    std::unordered_map<const operand*, literal>& a_encoded
+)
+{
+    auto l_it = a_encoded.find(&a_operand);
+
+    if (l_it != a_encoded.end())
+        // Shared subterms are encoded once.
+        return l_it->second;
+
+    literal l_result;
+
+    switch(a_operand.m_operand_type)
+    {
+        case UNRESOLVED:
+        {
+            l_result = variable(((const unresolved&)a_operand).m_variable);
+            break;
+        }
+        case RESOLVED:
+        {
+            // A variable forced to the value.
+            l_result = make_variable();
+            m_clauses.push_back({ ((const resolved&)a_operand).m_value ? l_result : -l_result });
+            break;
+        }
+        case INVERT:
+        {
+            // Inversion needs no variable of its own.
+            l_result = -encode(*((const invert&)a_operand).m_operand, a_encoded);
+            break;
+        }
+        case PRODUCT:
+        case SUM:
+        {
+            const operand::operand_list& l_operands = a_operand.m_operand_type == PRODUCT ?
+                ((const product&)a_operand).m_operands :
+                ((const sum&)a_operand).m_operands;
+
+            std::vector<literal> l_literals;
+
+            for (const operand::ptr& l_operand : l_operands)
+                l_literals.push_back(encode(*l_operand, a_encoded));
+
+            l_result = make_variable();
+
+            // For a product x = a && b: (!x || a), (!x || b), (x || !a || !b).
+            // A sum is the same with every literal inverted, by De Morgan's laws.
+            literal l_sign = a_operand.m_operand_type == PRODUCT ? 1 : -1;
+
+            clause l_clause = { l_sign * l_result };
+
+            for (const literal& l_literal : l_literals)
+            {
+                m_clauses.push_back({ -l_sign * l_result, l_sign * l_literal });
+                l_clause.push_back(-l_sign * l_literal);
+            }
+
+            m_clauses.push_back(l_clause);
+
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown operand type in cnf::encode()");
+        }
+    }
+
+    a_encoded[&a_operand] = l_result;
+
+    return l_result;
+
+}
+
+void cnf::require(
+    const operand& a_operand,
+    std::unordered_map<const operand*, literal>& a_encoded
+)
+{
+    switch(a_operand.m_operand_type)
+    {
+        case RESOLVED:
+        {
+            if (!((const resolved&)a_operand).m_value)
+                // The empty clause is unsatisfiable.
+                m_clauses.push_back({});
+
+            break;
+        }
+        case PRODUCT:
+        {
+            for (const operand::ptr& l_operand : ((const product&)a_operand).m_operands)
+                require(*l_operand, a_encoded);
+
+            break;
+        }
+        case SUM:
+        {
+            // A top-level sum is a single clause over its operands.
+            clause l_clause;
+
+            for (const operand::ptr& l_operand : ((const sum&)a_operand).m_operands)
+                l_clause.push_back(encode(*l_operand, a_encoded));
+
+            m_clauses.push_back(l_clause);
+
+            break;
+        }
+        default:
+        {
+            m_clauses.push_back({ encode(a_operand, a_encoded) });
+            break;
+        }
+    }
+
+}
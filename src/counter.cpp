@@ -0,0 +1,456 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+#include <assert.h>
+
+#include "include/counter.hpp"
+
+using namespace ba_calculator;
+
+natural::natural(
+    const std::uint64_t& a_value
+)
+{
+    for (std::uint64_t l_value = a_value; l_value != 0; l_value >>= 32)
+        m_digits.push_back(std::uint32_t(l_value));
+}
+
+natural natural::power_of_two(
+    const std::size_t& a_exponent
+)
+{
+    return natural(1) << a_exponent;
+}
+
+natural natural::operator+(
+    const natural& a_natural
+) const
+{
+    natural l_result;
+
+    std::uint64_t l_carry = 0;
+
+    for (std::size_t i = 0; i < std::max(m_digits.size(), a_natural.m_digits.size()) || l_carry; i++)
+    {
+        l_carry += i < m_digits.size() ? m_digits[i] : 0;
+        l_carry += i < a_natural.m_digits.size() ? a_natural.m_digits[i] : 0;
+
+        l_result.m_digits.push_back(std::uint32_t(l_carry));
+        l_carry >>= 32;
+    }
+
+    return l_result;
+
+}
+
+natural natural::operator-(
+    const natural& a_natural
+) const
+{
+    assert(!(*this < a_natural));
+
+    natural l_result;
+
+    std::int64_t l_borrow = 0;
+
+    for (std::size_t i = 0; i < m_digits.size(); i++)
+    {
+        std::int64_t l_digit = std::int64_t(m_digits[i]) - l_borrow;
+
+        if (i < a_natural.m_digits.size())
+            l_digit -= a_natural.m_digits[i];
+
+        l_borrow = l_digit < 0;
+
+        l_result.m_digits.push_back(std::uint32_t(l_digit + (l_borrow << 32)));
+    }
+
+    l_result.trim();
+
+    return l_result;
+
+}
+
+natural natural::operator*(
+    const natural& a_natural
+) const
+{
+    natural l_result;
+
+    if (m_digits.empty() || a_natural.m_digits.empty())
+        return l_result;
+
+    l_result.m_digits.assign(m_digits.size() + a_natural.m_digits.size(), 0);
+
+    for (std::size_t i = 0; i < m_digits.size(); i++)
+    {
+        std::uint64_t l_carry = 0;
+
+        for (std::size_t j = 0; j < a_natural.m_digits.size() || l_carry; j++)
+        {
+            l_carry += l_result.m_digits[i + j];
+
+            if (j < a_natural.m_digits.size())
+                l_carry += std::uint64_t(m_digits[i]) * a_natural.m_digits[j];
+
+            l_result.m_digits[i + j] = std::uint32_t(l_carry);
+            l_carry >>= 32;
+        }
+    }
+
+    l_result.trim();
+
+    return l_result;
+
+}
+
+natural natural::operator<<(
+    const std::size_t& a_shift
+) const
+{
+    natural l_result;
+
+    if (m_digits.empty())
+        return l_result;
+
+    std::size_t l_bits = a_shift % 32;
+
+    l_result.m_digits.assign(a_shift / 32, 0);
+
+    std::uint32_t l_carry = 0;
+
+    for (const std::uint32_t& l_digit : m_digits)
+    {
+        l_result.m_digits.push_back((l_digit << l_bits) | l_carry);
+        l_carry = l_bits == 0 ? 0 : l_digit >> (32 - l_bits);
+    }
+
+    l_result.m_digits.push_back(l_carry);
+    l_result.trim();
+
+    return l_result;
+
+}
+
+bool natural::operator==(
+    const natural& a_natural
+) const
+{
+    return m_digits == a_natural.m_digits;
+}
+
+bool natural::operator<(
+    const natural& a_natural
+) const
+{
+    if (m_digits.size() != a_natural.m_digits.size())
+        return m_digits.size() < a_natural.m_digits.size();
+
+    // Compare from the most significant digit down.
+    return std::lexicographical_compare(
+        m_digits.rbegin(),
+        m_digits.rend(),
+        a_natural.m_digits.rbegin(),
+        a_natural.m_digits.rend()
+    );
+
+}
+
+std::string natural::to_string(
+
+) const
+{
+    if (m_digits.empty())
+        return "0";
+
+    // Divide by 10^9 repeatedly, collecting nine decimal digits at a time.
+    std::vector<std::uint32_t> l_digits = m_digits;
+    std::vector<std::uint32_t> l_chunks;
+
+    while (!l_digits.empty())
+    {
+        std::uint64_t l_remainder = 0;
+
+        for (std::size_t i = l_digits.size(); i-- > 0;)
+        {
+            std::uint64_t l_value = (l_remainder << 32) | l_digits[i];
+            l_digits[i] = std::uint32_t(l_value / 1000000000);
+            l_remainder = l_value % 1000000000;
+        }
+
+        l_chunks.push_back(std::uint32_t(l_remainder));
+
+        while (!l_digits.empty() && l_digits.back() == 0)
+            l_digits.pop_back();
+    }
+
+    std::string l_result = std::to_string(l_chunks.back());
+
+    for (std::size_t i = l_chunks.size() - 1; i-- > 0;)
+    {
+        std::string l_chunk = std::to_string(l_chunks[i]);
+        l_result += std::string(9 - l_chunk.size(), '0') + l_chunk;
+    }
+
+    return l_result;
+
+}
+
+void natural::trim(
+
+)
+{
+    while (!m_digits.empty() && m_digits.back() == 0)
+        m_digits.pop_back();
+}
+
+model_counter::model_counter(
+
+) :
+    m_cache_hits(0)
+{
+
+}
+
+natural model_counter::count_models(
+    const operand::ptr& a_operand
+)
+{
+    auto l_it = m_cache.find(a_operand);
+
+    if (l_it != m_cache.end())
+    {
+        m_cache_hits++;
+        return l_it->second;
+    }
+
+    natural l_result;
+
+    switch(a_operand->m_operand_type)
+    {
+        case UNRESOLVED:
+        {
+            l_result = natural(1);
+            break;
+        }
+        case RESOLVED:
+        {
+            l_result = natural(((const resolved&)*a_operand).m_value);
+            break;
+        }
+        case INVERT:
+        {
+            // The inversion holds exactly where the operand does not, over the same support.
+            const operand::ptr& l_operand = ((const invert&)*a_operand).m_operand;
+            l_result = natural::power_of_two(a_operand->support().size()) - count_models(l_operand);
+            break;
+        }
+        case PRODUCT:
+        {
+            l_result = count_components(a_operand, ((const product&)*a_operand).m_operands);
+            break;
+        }
+        case SUM:
+        {
+            l_result = count_components(a_operand, ((const sum&)*a_operand).m_operands);
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown operand type in model_counter::count_models()");
+        }
+    }
+
+    m_cache.emplace(a_operand, l_result);
+
+    return l_result;
+
+}
+
+std::size_t model_counter::cache_size(
+
+) const
+{
+    return m_cache.size();
+}
+
+std::size_t model_counter::cache_hits(
+
+) const
+{
+    return m_cache_hits;
+}
+
+std::vector<std::vector<operand::ptr>> model_counter::components(
+    const operand::operand_list& a_operands
+)
+{
+    std::vector<std::size_t> l_parents(a_operands.size());
+    std::iota(l_parents.begin(), l_parents.end(), 0);
+
+    auto l_find = [&l_parents](
+        std::size_t a_index
+    )
+    {
+        while (l_parents[a_index] != a_index)
+            a_index = l_parents[a_index] = l_parents[l_parents[a_index]];
+
+        return a_index;
+    };
+
+    // Join each operand with the first operand sharing any of its variables.
+    std::unordered_map<std::size_t, std::size_t> l_owners;
+
+    for (std::size_t i = 0; i < a_operands.size(); i++)
+        for (const std::size_t& l_variable : a_operands[i]->support())
+        {
+            auto [l_it, l_is_inserted] = l_owners.emplace(l_variable, i);
+
+            if (!l_is_inserted)
+                l_parents[l_find(i)] = l_find(l_it->second);
+        }
+
+    std::vector<std::vector<operand::ptr>> l_result;
+    std::unordered_map<std::size_t, std::size_t> l_groups;
+
+    for (std::size_t i = 0; i < a_operands.size(); i++)
+    {
+        auto [l_it, l_is_inserted] = l_groups.emplace(l_find(i), l_result.size());
+
+        if (l_is_inserted)
+            l_result.emplace_back();
+
+        l_result[l_it->second].push_back(a_operands[i]);
+    }
+
+    return l_result;
+
+}
+
+std::size_t model_counter::branching_variable(
+    const operand::operand_list& a_operands
+)
+{
+    // The variable id of a literal, or npos for anything else.
+    auto l_literal_variable = [](
+        const operand::ptr& a_operand
+    )
+    {
+        const operand* l_operand = a_operand.get();
+
+        if (l_operand->m_operand_type == INVERT)
+            l_operand = ((const invert&)*l_operand).m_operand.get();
+
+        if (l_operand->m_operand_type != UNRESOLVED)
+            return symbol_table::npos;
+
+        return ((const unresolved*)l_operand)->m_variable;
+    };
+
+    std::unordered_map<std::size_t, std::size_t> l_occurrences;
+
+    // Variables found as literals near the top are counted again, since
+    // binding them simplifies the most of the operand at the least cost.
+    std::unordered_map<std::size_t, std::size_t> l_shallow_occurrences;
+
+    for (const operand::ptr& l_operand : a_operands)
+    {
+        for (const std::size_t& l_variable : l_operand->support())
+            l_occurrences[l_variable]++;
+
+        l_shallow_occurrences[l_literal_variable(l_operand)]++;
+
+        if (l_operand->m_operand_type == PRODUCT)
+            for (const operand::ptr& l_child : ((const product&)*l_operand).m_operands)
+                l_shallow_occurrences[l_literal_variable(l_child)]++;
+        else if (l_operand->m_operand_type == SUM)
+            for (const operand::ptr& l_child : ((const sum&)*l_operand).m_operands)
+                l_shallow_occurrences[l_literal_variable(l_child)]++;
+    }
+
+    // Break the remaining ties toward the smallest id, so that the choice is deterministic.
+    std::size_t l_best = 0;
+    std::pair<std::size_t, std::size_t> l_best_score = { 0, 0 };
+
+    for (const auto& [l_variable, l_count] : l_occurrences)
+    {
+        std::pair<std::size_t, std::size_t> l_score = { l_count, l_shallow_occurrences[l_variable] };
+
+        if (l_score > l_best_score || (l_score == l_best_score && l_variable < l_best))
+        {
+            l_best = l_variable;
+            l_best_score = l_score;
+        }
+    }
+
+    return l_best;
+
+}
+
+natural model_counter::count_components(
+    const operand::ptr& a_operand,
+    const operand::operand_list& a_operands
+)
+{
+    std::vector<std::vector<operand::ptr>> l_components = components(a_operands);
+
+    if (a_operands.size() == 1)
+        // A product or sum of a single operand is just that operand.
+        return count_models(a_operands[0]);
+
+    if (l_components.size() == 1)
+        // Nothing to decompose, so split on the most shared variable instead.
+        return count_cofactors(a_operand, branching_variable(a_operands));
+
+    // A product holds where every component does, and a sum fails
+    // where every component fails, over their disjoint supports.
+    bool l_is_product = a_operand->m_operand_type == PRODUCT;
+
+    natural l_result(1);
+
+    for (const std::vector<operand::ptr>& l_component : l_components)
+    {
+        operand::ptr l_operand = l_component[0];
+
+        if (l_component.size() > 1 && l_is_product)
+            l_operand = operand::ptr(new product(l_component));
+        else if (l_component.size() > 1)
+            l_operand = operand::ptr(new sum(l_component));
+
+        natural l_count = count_models(l_operand);
+
+        if (l_is_product)
+            l_result = l_result * l_count;
+        else
+            l_result = l_result * (natural::power_of_two(l_operand->support().size()) - l_count);
+    }
+
+    if (l_is_product)
+        return l_result;
+
+    return natural::power_of_two(a_operand->support().size()) - l_result;
+
+}
+
+natural model_counter::count_cofactors(
+    const operand::ptr& a_operand,
+    const std::size_t& a_variable
+)
+{
+    std::size_t l_support_size = a_operand->support().size();
+
+    natural l_result;
+
+    for (const bool l_value : { false, true })
+    {
+        operand::ptr l_cofactor = a_operand->cofactor(a_variable, l_value);
+
+        // Variables which vanished from the cofactor may take either value.
+        l_result = l_result + (count_models(l_cofactor) << (l_support_size - 1 - l_cofactor->support().size()));
+    }
+
+    return l_result;
+
+}
@@ -0,0 +1,338 @@
+#include <algorithm>
+#include <bit>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+#include <unordered_set>
+
+#include "include/calculator.hpp"
+
+using namespace ba_calculator;
+
+namespace
+{
+    const unresolved& literal_variable(
+        const operand::ptr& a_literal
+    )
+    {
+        // Each operand in the product will be a literal.
+        assert(a_literal->m_operand_type == INVERT || a_literal->m_operand_type == UNRESOLVED);
+
+        if (a_literal->m_operand_type == INVERT)
+        {
+            const operand::ptr& l_operand = ((const invert&)*a_literal).m_operand;
+            assert(l_operand->m_operand_type == UNRESOLVED);
+            return (const unresolved&)*l_operand;
+        }
+
+        return (const unresolved&)*a_literal;
+        
+    }
+
+    const operand::operand_list& product_literals(
+        const operand::ptr& a_product
+    )
+    {
+        assert(a_product->m_operand_type == PRODUCT);
+        return ((const product&)*a_product).m_operands;
+    }
+    
+}
+
+cover::cover(
+    const std::vector<std::size_t>& a_variables
+) :
+    m_variables(a_variables)
+{
+
+}
+
+cover::cover(
+    const std::vector<operand::ptr>& a_products
+)
+{
+    // Only index the variables which actually appear, so that
+    // the cubes are no wider than they need to be.
+    for (const operand::ptr& l_product : a_products)
+        for (const operand::ptr& l_literal : product_literals(l_product))
+            m_variables.push_back(literal_variable(l_literal).m_variable);
+
+    std::sort(m_variables.begin(), m_variables.end());
+    m_variables.erase(std::unique(m_variables.begin(), m_variables.end()), m_variables.end());
+
+    m_cubes.reserve(a_products.size());
+
+    for (const operand::ptr& l_product : a_products)
+    {
+        cube l_cube = make_cube();
+
+        for (const operand::ptr& l_literal : product_literals(l_product))
+        {
+            auto l_index = std::lower_bound(
+                m_variables.begin(),
+                m_variables.end(),
+                literal_variable(l_literal).m_variable
+            );
+
+            l_cube.insert(l_index - m_variables.begin(), l_literal->m_operand_type == UNRESOLVED);
+        }
+
+        m_cubes.push_back(l_cube);
+        
+    }
+    
+}
+
+cover cover::of(
+    const operand::ptr& a_operand
+)
+{
+    operand::ptr l_reduced = a_operand->reduce();
+
+    switch(l_reduced->m_operand_type)
+    {
+        case RESOLVED:
+        {
+            cover l_result(std::vector<std::size_t>{});
+
+            if (((const resolved&)*l_reduced).m_value)
+                // The universal cube.
+                l_result.m_cubes.push_back(l_result.make_cube());
+
+            return l_result;
+        }
+        case UNRESOLVED:
+        case INVERT:
+        {
+            // A lone literal.
+            return cover(std::vector<operand::ptr>{ operand::ptr(new product({l_reduced})) });
+        }
+        case SUM:
+        {
+            const sum& l_sum = (const sum&)*l_reduced;
+
+            return cover(std::vector<operand::ptr>(l_sum.m_operands.begin(), l_sum.m_operands.end()));
+        }
+        default:
+        {
+            throw std::runtime_error("Error: operand did not reduce to a sum of products in cover::of()");
+        }
+    }
+    
+}
+
+cube cover::make_cube(
+
+) const
+{
+    return cube(m_variables.size());
+}
+
+operand::ptr cover::to_operand(
+
+) const
+{
+    std::vector<operand::ptr> l_products;
+
+    for (const cube& l_cube : m_cubes)
+    {
+        std::vector<operand::ptr> l_literals;
+
+        for (std::size_t i = 0; i < m_variables.size(); i++)
+        {
+            if (l_cube.contains(i, true))
+                l_literals.push_back(operand::ptr(new unresolved(m_variables[i])));
+            else if (l_cube.contains(i, false))
+                l_literals.push_back(operand::ptr(new invert(operand::ptr(new unresolved(m_variables[i])))));
+        }
+
+        if (l_literals.empty())
+            // The universal cube absorbs the whole sum.
+            return operand::ptr(new resolved(1));
+
+        l_products.push_back(operand::ptr(new product(std::move(l_literals))));
+        
+    }
+
+    if (l_products.empty())
+        return operand::ptr(new resolved(0));
+
+    return operand::ptr(new sum(std::move(l_products)));
+    
+}
+
+void cover::prune(
+
+)
+{
+    // Cubes holding a variable in both polarities are 0, and contribute nothing.
+    m_cubes.erase(
+        std::remove_if(
+            m_cubes.begin(),
+            m_cubes.end(),
+            [](
+                const cube& a_cube
+            )
+            {
+                return a_cube.conflicts(a_cube);
+            }
+        ),
+        m_cubes.end()
+    );
+
+    // Each merge may in turn cover other cubes, so repeat
+    // until neither pass finds anything more to do.
+    remove_covered(m_cubes);
+
+    while (merge_opposites(m_cubes))
+        remove_covered(m_cubes);
+    
+}
+
+std::size_t cover::literal_count(
+
+) const
+{
+    std::size_t l_result = 0;
+
+    for (const cube& l_cube : m_cubes)
+        l_result += l_cube.literal_count();
+
+    return l_result;
+    
+}
+
+void cover::remove_covered(
+    std::vector<cube>& a_cubes
+)
+{
+    // Order the cubes by their literal count, since a cube
+    // can only be covered by one with fewer literals than itself.
+    std::stable_sort(
+        a_cubes.begin(),
+        a_cubes.end(),
+        [](
+            const cube& a_cube_0,
+            const cube& a_cube_1
+        )
+        {
+            return a_cube_0.literal_count() < a_cube_1.literal_count();
+        }
+    );
+
+    // The cubes which are not covered by any other. Since every cube which
+    // could cover the current one has already been visited, a single query
+    // against the trie of kept cubes decides whether it is kept.
+    std::vector<cube> l_kept;
+    cube_trie         l_index;
+
+    for (const cube& l_cube : a_cubes)
+    {
+        if (l_index.covers(l_cube))
+            continue;
+
+        l_index.insert(l_cube);
+        l_kept.push_back(l_cube);
+        
+    }
+
+    a_cubes.swap(l_kept);
+    
+}
+
+bool cover::merge_opposites(
+    std::vector<cube>& a_cubes
+)
+{
+    // Index every cube under each of its literals removed, alongside the
+    // variable that was removed. Two cubes which differ only in the polarity
+    // of one variable share such a key, so partners are found by lookup
+    // rather than by comparing every pair.
+    std::unordered_map<cube, std::vector<std::pair<std::size_t, std::size_t>>, cube::hasher> l_index;
+
+    std::vector<cube> l_merged;
+    std::vector<bool> l_is_merged(a_cubes.size());
+
+    for (std::size_t i = 0; i < a_cubes.size(); i++)
+    {
+        const cube& l_cube = a_cubes[i];
+
+        for (std::size_t l_word = 0; l_word < l_cube.m_positive.size(); l_word++)
+        {
+            for (const bool l_polarity : { true, false })
+            {
+                std::uint64_t l_bits = l_polarity ? l_cube.m_positive[l_word] : l_cube.m_negative[l_word];
+
+                for (; l_bits != 0; l_bits &= l_bits - 1)
+                {
+                    std::size_t l_variable = l_word * 64 + std::countr_zero(l_bits);
+
+                    cube l_key = l_cube;
+                    l_key.erase(l_variable, l_polarity);
+
+                    std::vector<std::pair<std::size_t, std::size_t>>& l_partners = l_index[l_key];
+
+                    for (const auto& [l_partner, l_partner_variable] : l_partners)
+                    {
+                        if (l_partner_variable != l_variable || !are_opposites(l_cube, a_cubes[l_partner]))
+                            continue;
+
+                        // x && k || !x && k is just k.
+                        l_merged.push_back(l_key);
+                        l_is_merged[i] = true;
+                        l_is_merged[l_partner] = true;
+                    }
+
+                    l_partners.push_back({i, l_variable});
+                }
+            }
+        }
+        
+    }
+
+    if (l_merged.empty())
+        return false;
+
+    // The merged cubes cover both of their halves, so only the
+    // cubes which merged with nothing are carried over.
+    for (std::size_t i = 0; i < a_cubes.size(); i++)
+        if (!l_is_merged[i])
+            l_merged.push_back(a_cubes[i]);
+
+    std::unordered_set<cube, cube::hasher> l_unique(l_merged.begin(), l_merged.end());
+
+    a_cubes.assign(l_unique.begin(), l_unique.end());
+
+    return true;
+    
+}
+
+bool cover::are_opposites(
+    const cube& a_cube_0,
+    const cube& a_cube_1
+)
+{
+    std::size_t l_difference_count = 0;
+
+    for (std::size_t i = 0; i < a_cube_0.m_positive.size(); i++)
+    {
+        std::uint64_t l_positive_difference = a_cube_0.m_positive[i] ^ a_cube_1.m_positive[i];
+        std::uint64_t l_negative_difference = a_cube_0.m_negative[i] ^ a_cube_1.m_negative[i];
+
+        // The cubes may only differ where one holds a variable
+        // positively and the other holds it negatively.
+        std::uint64_t l_opposed =
+            (a_cube_0.m_positive[i] & a_cube_1.m_negative[i]) |
+            (a_cube_0.m_negative[i] & a_cube_1.m_positive[i]);
+
+        if (l_positive_difference != l_opposed || l_negative_difference != l_opposed)
+            return false;
+
+        l_difference_count += std::popcount(l_opposed);
+        
+    }
+
+    return l_difference_count == 1;
+    
+}
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <bit>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/calculator.hpp"
+
+using namespace ba_calculator;
+
+std::size_t cube::hasher::operator()(
+    const cube& a_cube
+) const
+{
+    std::size_t l_result = 0;
+
+    for (std::size_t i = 0; i < a_cube.m_positive.size(); i++)
+    {
+        l_result = l_result * 0x9e3779b97f4a7c15ULL + a_cube.m_positive[i];
+        l_result = l_result * 0x9e3779b97f4a7c15ULL + a_cube.m_negative[i];
+    }
+
+    return l_result ^ (l_result >> 29);
+    
+}
+
+cube::cube(
+    const std::size_t& a_variable_count
+) :
+    m_positive((a_variable_count + 63) / 64),
+    m_negative((a_variable_count + 63) / 64)
+{
+
+}
+
+void cube::insert(
+    const std::size_t& a_variable,
+    const bool& a_polarity
+)
+{
+    std::vector<std::uint64_t>& l_mask = a_polarity ? m_positive : m_negative;
+    l_mask[a_variable / 64] |= std::uint64_t(1) << (a_variable % 64);
+}
+
+void cube::erase(
+    const std::size_t& a_variable,
+    const bool& a_polarity
+)
+{
+    std::vector<std::uint64_t>& l_mask = a_polarity ? m_positive : m_negative;
+    l_mask[a_variable / 64] &= ~(std::uint64_t(1) << (a_variable % 64));
+}
+
+bool cube::contains(
+    const std::size_t& a_variable,
+    const bool& a_polarity
+) const
+{
+    const std::vector<std::uint64_t>& l_mask = a_polarity ? m_positive : m_negative;
+    return (l_mask[a_variable / 64] >> (a_variable % 64)) & 1;
+}
+
+std::size_t cube::literal_count(
+
+) const
+{
+    std::size_t l_result = 0;
+
+    for (std::size_t i = 0; i < m_positive.size(); i++)
+        l_result += std::popcount(m_positive[i]) + std::popcount(m_negative[i]);
+
+    return l_result;
+    
+}
+
+bool cube::covers(
+    const cube& a_cube
+) const
+{
+    assert(m_positive.size() == a_cube.m_positive.size());
+    
+    // Accumulate the literals missing from the given cube without branching,
+    // so that the loop is a straight run of AND/OR over words, which the
+    // compiler is free to vectorize.
+    std::uint64_t l_missing = 0;
+
+    for (std::size_t i = 0; i < m_positive.size(); i++)
+        l_missing |=
+            (m_positive[i] & ~a_cube.m_positive[i]) |
+            (m_negative[i] & ~a_cube.m_negative[i]);
+
+    return l_missing == 0;
+    
+}
+
+bool cube::conflicts(
+    const cube& a_cube
+) const
+{
+    assert(m_positive.size() == a_cube.m_positive.size());
+
+    std::uint64_t l_opposed = 0;
+
+    for (std::size_t i = 0; i < m_positive.size(); i++)
+        l_opposed |=
+            (m_positive[i] & a_cube.m_negative[i]) |
+            (m_negative[i] & a_cube.m_positive[i]);
+
+    return l_opposed != 0;
+    
+}
+
+bool cube::operator==(
+    const cube& a_cube
+) const
+{
+    return m_positive == a_cube.m_positive && m_negative == a_cube.m_negative;
+}
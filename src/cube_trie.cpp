@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <bit>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/calculator.hpp"
+
+using namespace ba_calculator;
+
+cube_trie::cube_trie(
+
+) :
+    m_nodes(1),
+    m_size(0)
+{
+
+}
+
+void cube_trie::insert(
+    const cube& a_cube
+)
+{
+    std::size_t l_node = 0;
+
+    for (const std::size_t& l_literal : literals(a_cube))
+    {
+        std::vector<std::pair<std::size_t, std::size_t>>& l_children = m_nodes[l_node].m_children;
+
+        auto l_it = std::lower_bound(
+            l_children.begin(),
+            l_children.end(),
+            std::pair<std::size_t, std::size_t>(l_literal, 0)
+        );
+
+        if (l_it != l_children.end() && l_it->first == l_literal)
+        {
+            l_node = l_it->second;
+            continue;
+        }
+
+        // Growing m_nodes invalidates l_children, so record the edge first.
+        std::size_t l_child = m_nodes.size();
+        l_children.insert(l_it, {l_literal, l_child});
+        m_nodes.emplace_back();
+        l_node = l_child;
+        
+    }
+
+    if (!m_nodes[l_node].m_is_terminal)
+        m_size++;
+
+    m_nodes[l_node].m_is_terminal = true;
+    
+}
+
+bool cube_trie::covers(
+    const cube& a_cube
+) const
+{
+    std::vector<std::size_t> l_literals = literals(a_cube);
+
+    // Pairs of a node, and the position in l_literals from
+    // which the literals of its children may be drawn.
+    std::vector<std::pair<std::size_t, std::size_t>> l_pending = {{0, 0}};
+
+    while (!l_pending.empty())
+    {
+        auto [l_node, l_position] = l_pending.back();
+        l_pending.pop_back();
+
+        if (m_nodes[l_node].m_is_terminal)
+            // Every literal on the path to this node is in the given cube.
+            return true;
+
+        const std::vector<std::pair<std::size_t, std::size_t>>& l_children = m_nodes[l_node].m_children;
+
+        // Both lists are ascending, so walk them together to find
+        // the children whose literals the given cube holds.
+        auto l_child = l_children.begin();
+
+        for (std::size_t i = l_position; i < l_literals.size() && l_child != l_children.end(); )
+        {
+            if (l_child->first < l_literals[i])
+                l_child++;
+            else if (l_literals[i] < l_child->first)
+                i++;
+            else
+            {
+                l_pending.push_back({l_child->second, i + 1});
+                l_child++;
+                i++;
+            }
+        }
+        
+    }
+
+    return false;
+    
+}
+
+std::size_t cube_trie::size(
+
+) const
+{
+    return m_size;
+}
+
+std::vector<std::size_t> cube_trie::literals(
+    const cube& a_cube
+)
+{
+    std::vector<std::size_t> l_result;
+
+    for (std::size_t l_word = 0; l_word < a_cube.m_positive.size(); l_word++)
+    {
+        for (std::uint64_t l_bits = a_cube.m_positive[l_word]; l_bits != 0; l_bits &= l_bits - 1)
+            l_result.push_back(2 * (l_word * 64 + std::countr_zero(l_bits)));
+
+        for (std::uint64_t l_bits = a_cube.m_negative[l_word]; l_bits != 0; l_bits &= l_bits - 1)
+            l_result.push_back(2 * (l_word * 64 + std::countr_zero(l_bits)) + 1);
+    }
+
+    std::sort(l_result.begin(), l_result.end());
+
+    return l_result;
+    
+}
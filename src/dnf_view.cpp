@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/dnf_view.hpp"
+
+using namespace ba_calculator;
+
+dnf_view::dnf_view(
+    const operand::ptr& a_operand
+) :
+    m_operand(a_operand)
+{
+    std::map<std::pair<const operand*, bool>, std::size_t> l_shapes;
+
+    m_root = open(build(*a_operand, false, l_shapes));
+}
+
+bool dnf_view::next(
+    operand::ptr& a_product
+)
+{
+    if (!advance(m_root))
+        return false;
+
+    const std::vector<std::size_t>& l_term = m_cursors[m_root].m_term;
+
+    std::vector<operand::ptr> l_literals;
+
+    for (const std::size_t& l_literal : l_term)
+    {
+        operand::ptr l_variable(new unresolved(l_literal / 2));
+
+        if (l_literal % 2 == 0)
+            l_literals.push_back(l_variable);
+        else
+            l_literals.push_back(operand::ptr(new invert(l_variable)));
+    }
+
+    a_product = operand::ptr(new product(std::move(l_literals)));
+
+    return true;
+
+}
+
+void dnf_view::reset(
+
+)
+{
+    reset(m_root);
+}
+
+std::size_t dnf_view::build(
+    const operand& a_operand,
+    const bool& a_is_negated,
+    std::map<std::pair<const operand*, bool>, std::size_t>& a_shapes
+)
+{
+    if (a_operand.m_operand_type == INVERT)
+        return build(*((const invert&)a_operand).m_operand, !a_is_negated, a_shapes);
+
+    auto l_existing = a_shapes.find({ &a_operand, a_is_negated });
+
+    if (l_existing != a_shapes.end())
+        return l_existing->second;
+
+    shape l_shape{ LITERAL, 0, {}, false };
+
+    switch(a_operand.m_operand_type)
+    {
+        case UNRESOLVED:
+        {
+            l_shape.m_payload = 2 * ((const unresolved&)a_operand).m_variable + a_is_negated;
+            break;
+        }
+        case RESOLVED:
+        {
+            l_shape.m_kind = CONSTANT;
+            l_shape.m_payload = ((const resolved&)a_operand).m_value != a_is_negated;
+            l_shape.m_is_empty = l_shape.m_payload == 0;
+            break;
+        }
+        case PRODUCT:
+        case SUM:
+        {
+            // By De Morgan's laws, a negated product is a sum of negated
+            // operands, and a negated sum is a product of negated operands.
+            l_shape.m_kind = (a_operand.m_operand_type == PRODUCT) != a_is_negated ? CONJUNCTION : DISJUNCTION;
+
+            const operand::operand_list& l_operands = a_operand.m_operand_type == PRODUCT ?
+                ((const product&)a_operand).m_operands :
+                ((const sum&)a_operand).m_operands;
+
+            // The empty sum is 0, and the empty product is 1.
+            l_shape.m_is_empty = l_shape.m_kind == DISJUNCTION;
+
+            for (const operand::ptr& l_operand : l_operands)
+            {
+                std::size_t l_child = build(*l_operand, a_is_negated, a_shapes);
+
+                if (l_shape.m_kind == CONJUNCTION)
+                    l_shape.m_is_empty = l_shape.m_is_empty || m_shapes[l_child].m_is_empty;
+                else
+                    l_shape.m_is_empty = l_shape.m_is_empty && m_shapes[l_child].m_is_empty;
+
+                l_shape.m_children.push_back(l_child);
+            }
+
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown operand type in dnf_view::build()");
+        }
+    }
+
+    m_shapes.push_back(std::move(l_shape));
+
+    return a_shapes[{ &a_operand, a_is_negated }] = m_shapes.size() - 1;
+
+}
+
+std::size_t dnf_view::open(
+    const std::size_t& a_shape
+)
+{
+    std::size_t l_index;
+
+    if (m_free.empty())
+    {
+        m_cursors.emplace_back();
+        l_index = m_cursors.size() - 1;
+    }
+    else
+    {
+        l_index = m_free.back();
+        m_free.pop_back();
+    }
+
+    cursor& l_cursor = m_cursors[l_index];
+    const shape& l_shape = m_shapes[a_shape];
+
+    l_cursor.m_shape = a_shape;
+    l_cursor.m_children.clear();
+    l_cursor.m_position = 0;
+    l_cursor.m_prefixes.resize(l_shape.m_kind == CONJUNCTION ? l_shape.m_children.size() : 0);
+
+    return l_index;
+
+}
+
+void dnf_view::close(
+    const std::size_t& a_cursor
+)
+{
+    reset(a_cursor);
+
+    m_free.push_back(a_cursor);
+
+}
+
+bool dnf_view::advance(
+    const std::size_t& a_cursor
+)
+{
+    cursor& l_cursor = m_cursors[a_cursor];
+    const shape& l_shape = m_shapes[l_cursor.m_shape];
+
+    switch(l_shape.m_kind)
+    {
+        case LITERAL:
+        case CONSTANT:
+        {
+            if (l_cursor.m_position != 0)
+                return false;
+
+            l_cursor.m_position = 1;
+
+            if (l_shape.m_kind == CONSTANT)
+            {
+                // 1 is the empty product, and 0 has no products at all.
+                l_cursor.m_term.clear();
+                return l_shape.m_payload != 0;
+            }
+
+            l_cursor.m_term = { l_shape.m_payload };
+
+            return true;
+        }
+        case DISJUNCTION:
+        {
+            for (; l_cursor.m_position < l_shape.m_children.size(); l_cursor.m_position++)
+            {
+                if (l_cursor.m_children.empty())
+                {
+                    std::size_t l_child_shape = l_shape.m_children[l_cursor.m_position];
+
+                    if (m_shapes[l_child_shape].m_is_empty)
+                        continue;
+
+                    l_cursor.m_children.push_back(open(l_child_shape));
+                }
+
+                std::size_t l_child = l_cursor.m_children[0];
+
+                if (advance(l_child))
+                {
+                    l_cursor.m_term = m_cursors[l_child].m_term;
+                    return true;
+                }
+
+                // Done with the operand, so its cursors go to the next one.
+                close(l_child);
+                l_cursor.m_children.clear();
+            }
+
+            return false;
+        }
+        case CONJUNCTION:
+        {
+            std::size_t l_count = l_shape.m_children.size();
+
+            if (l_count == 0)
+            {
+                // The empty product is 1.
+                l_cursor.m_term.clear();
+                return l_cursor.m_position++ == 0;
+            }
+
+            if (l_shape.m_is_empty)
+                // Rather than run through every combination of the operands
+                // before the empty one, only to find it empty each time.
+                l_cursor.m_position = 2;
+
+            if (l_cursor.m_position == 2)
+                return false;
+
+            if (l_cursor.m_position == 0)
+                for (const std::size_t& l_child_shape : l_shape.m_children)
+                    l_cursor.m_children.push_back(open(l_child_shape));
+
+            // Resume from the last operand, or begin from the first.
+            std::size_t i = l_cursor.m_position == 0 ? 0 : l_count - 1;
+
+            // Whether operand i was just reset, so that it has yet to yield a term.
+            bool l_is_fresh = l_cursor.m_position == 0;
+
+            l_cursor.m_position = 1;
+
+            static const std::vector<std::size_t> s_empty;
+
+            while (true)
+            {
+                std::size_t l_child = l_cursor.m_children[i];
+
+                if (!advance(l_child))
+                {
+                    if (i == 0 || l_is_fresh)
+                    {
+                        // An operand which yields no term at all, as when each of
+                        // its own terms conflicts, does so after every prefix.
+                        l_cursor.m_position = 2;
+                        return false;
+                    }
+
+                    // Carry into the previous operand.
+                    i--;
+                    continue;
+                }
+
+                l_is_fresh = false;
+
+                const std::vector<std::size_t>& l_prefix = i == 0 ? s_empty : l_cursor.m_prefixes[i - 1];
+
+                if (!merge(l_prefix, m_cursors[l_child].m_term, l_cursor.m_prefixes[i]))
+                    // Every combination of the later operands would conflict as well.
+                    continue;
+
+                if (i == l_count - 1)
+                {
+                    l_cursor.m_term = l_cursor.m_prefixes[i];
+                    return true;
+                }
+
+                i++;
+                reset(l_cursor.m_children[i]);
+                l_is_fresh = true;
+            }
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown cursor kind in dnf_view::advance()");
+        }
+    }
+
+}
+
+void dnf_view::reset(
+    const std::size_t& a_cursor
+)
+{
+    cursor& l_cursor = m_cursors[a_cursor];
+
+    l_cursor.m_position = 0;
+
+    // The cursors of the operands are opened again as they are reached.
+    for (const std::size_t& l_child : l_cursor.m_children)
+        close(l_child);
+
+    l_cursor.m_children.clear();
+
+}
+
+bool dnf_view::merge(
+    const std::vector<std::size_t>& a_literals_0,
+    const std::vector<std::size_t>& a_literals_1,
+    std::vector<std::size_t>& a_result
+)
+{
+    a_result.clear();
+
+    std::set_union(
+        a_literals_0.begin(),
+        a_literals_0.end(),
+        a_literals_1.begin(),
+        a_literals_1.end(),
+        std::back_inserter(a_result)
+    );
+
+    // A variable in both polarities has adjacent literals 2v and 2v + 1.
+    for (std::size_t i = 0; i + 1 < a_result.size(); i++)
+        if (a_result[i] % 2 == 0 && a_result[i + 1] == a_result[i] + 1)
+            return false;
+
+    return true;
+
+}
@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/enumerator.hpp"
+
+using namespace ba_calculator;
+
+enumerator::enumerator(
+    const operand::ptr& a_operand
+) :
+    m_operand(a_operand),
+    m_variables(a_operand->support()),
+    m_is_started(false),
+    m_path(m_variables.size()),
+    m_cube(m_variables.size()),
+    m_has_cube(false)
+{
+
+}
+
+const std::vector<std::size_t>& enumerator::variables(
+
+) const
+{
+    return m_variables;
+}
+
+bool enumerator::next_cube(
+    cube& a_cube
+)
+{
+    if (!m_is_started)
+    {
+        m_is_started = true;
+
+        // Without any variables, the operand reduces to a constant.
+        operand::ptr l_operand = m_variables.empty() ? m_operand->reduce() : m_operand;
+
+        if (l_operand->m_operand_type == RESOLVED)
+        {
+            // Every assignment satisfies 1, and none satisfy 0.
+            a_cube = m_path;
+            return ((const resolved&)*l_operand).m_value;
+        }
+
+        push(l_operand);
+    }
+
+    while (!m_frames.empty())
+    {
+        frame& l_frame = m_frames.back();
+
+        std::size_t l_index = l_frame.m_index;
+
+        if (l_frame.m_next_value == 2)
+        {
+            // Both values were tried, so unbind the variable and backtrack.
+            m_path.erase(l_index, true);
+            m_path.erase(l_index, false);
+            m_frames.pop_back();
+            continue;
+        }
+
+        bool l_value = l_frame.m_next_value++;
+
+        m_path.erase(l_index, !l_value);
+        m_path.insert(l_index, l_value);
+
+        operand::ptr l_cofactor = l_frame.m_operand->cofactor(m_variables[l_index], l_value);
+
+        if (l_cofactor->support().empty())
+            // Constants are folded only where the variable was bound, so
+            // constant operands elsewhere may remain, such as a product of 1.
+            l_cofactor = l_cofactor->reduce();
+
+        if (l_cofactor->m_operand_type != RESOLVED)
+        {
+            push(l_cofactor);
+            continue;
+        }
+
+        if (((const resolved&)*l_cofactor).m_value)
+        {
+            a_cube = m_path;
+            return true;
+        }
+    }
+
+    return false;
+
+}
+
+bool enumerator::next_assignment(
+    std::vector<bool>& a_assignment
+)
+{
+    if (m_has_cube)
+    {
+        // Count through the values of the free variables.
+        std::size_t i = 0;
+
+        while (i < m_free_values.size() && m_free_values[i])
+            m_free_values[i++] = false;
+
+        if (i < m_free_values.size())
+            m_free_values[i] = true;
+        else
+            m_has_cube = false;
+    }
+
+    if (!m_has_cube)
+    {
+        if (!next_cube(m_cube))
+            return false;
+
+        m_free.clear();
+
+        for (std::size_t i = 0; i < m_variables.size(); i++)
+            if (!m_cube.contains(i, true) && !m_cube.contains(i, false))
+                m_free.push_back(i);
+
+        m_free_values.assign(m_free.size(), false);
+        m_has_cube = true;
+    }
+
+    a_assignment.assign(m_variables.size(), false);
+
+    for (std::size_t i = 0; i < m_variables.size(); i++)
+        a_assignment[i] = m_cube.contains(i, true);
+
+    for (std::size_t i = 0; i < m_free.size(); i++)
+        a_assignment[m_free[i]] = m_free_values[i];
+
+    return true;
+
+}
+
+void enumerator::push(
+    const operand::ptr& a_operand
+)
+{
+    // The operand depends on none of the bound variables, so its
+    // first variable is the first one left unbound along the path.
+    auto l_index = std::lower_bound(m_variables.begin(), m_variables.end(), a_operand->support().front());
+
+    m_frames.push_back(frame{ a_operand, std::size_t(l_index - m_variables.begin()), 0 });
+
+}
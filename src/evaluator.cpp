@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/evaluator.hpp"
+
+using namespace ba_calculator;
+
+evaluator::evaluator(
+    const operand::ptr& a_operand
+) :
+    m_variables(a_operand->support())
+{
+    std::unordered_map<const operand*, std::size_t> l_registers;
+
+    compile(*a_operand, l_registers);
+
+    m_registers.assign(m_instructions.size() * LANES, 0);
+
+}
+
+std::uint64_t evaluator::evaluate(
+    const std::vector<std::uint64_t>& a_inputs
+)
+{
+    assert(a_inputs.size() == m_variables.size());
+
+    std::uint64_t l_result = 0;
+
+    evaluate(a_inputs.data(), 1, &l_result);
+
+    return l_result;
+    
+}
+
+void evaluator::evaluate(
+    const std::uint64_t* a_inputs,
+    const std::size_t& a_word_count,
+    std::uint64_t* a_outputs
+)
+{
+    std::vector<std::uint64_t>& l_registers = m_registers;
+
+    for (std::size_t l_word = 0; l_word < a_word_count; l_word += LANES)
+    {
+        // The final block may be only partially filled.
+        std::size_t l_lanes = std::min(LANES, a_word_count - l_word);
+
+        for (std::size_t i = 0; i < m_instructions.size(); i++)
+        {
+            const instruction& l_instruction = m_instructions[i];
+
+            std::uint64_t* l_register = &l_registers[i * LANES];
+
+            switch(l_instruction.m_opcode)
+            {
+                case CONSTANT:
+                {
+                    std::uint64_t l_value = l_instruction.m_begin ? ~std::uint64_t(0) : 0;
+
+                    for (std::size_t l_lane = 0; l_lane < LANES; l_lane++)
+                        l_register[l_lane] = l_value;
+                    
+                    break;
+                }
+                case LOAD:
+                {
+                    const std::uint64_t* l_input = a_inputs + l_instruction.m_begin * a_word_count + l_word;
+
+                    for (std::size_t l_lane = 0; l_lane < LANES; l_lane++)
+                        l_register[l_lane] = l_lane < l_lanes ? l_input[l_lane] : 0;
+                    
+                    break;
+                }
+                case NOT:
+                {
+                    const std::uint64_t* l_source = &l_registers[l_instruction.m_begin * LANES];
+
+                    for (std::size_t l_lane = 0; l_lane < LANES; l_lane++)
+                        l_register[l_lane] = ~l_source[l_lane];
+                    
+                    break;
+                }
+                case AND:
+                {
+                    for (std::size_t l_lane = 0; l_lane < LANES; l_lane++)
+                        l_register[l_lane] = ~std::uint64_t(0);
+
+                    for (std::size_t j = l_instruction.m_begin; j < l_instruction.m_end; j++)
+                    {
+                        const std::uint64_t* l_source = &l_registers[m_arguments[j] * LANES];
+
+                        for (std::size_t l_lane = 0; l_lane < LANES; l_lane++)
+                            l_register[l_lane] &= l_source[l_lane];
+                    }
+                    
+                    break;
+                }
+                case OR:
+                {
+                    for (std::size_t l_lane = 0; l_lane < LANES; l_lane++)
+                        l_register[l_lane] = 0;
+
+                    for (std::size_t j = l_instruction.m_begin; j < l_instruction.m_end; j++)
+                    {
+                        const std::uint64_t* l_source = &l_registers[m_arguments[j] * LANES];
+
+                        for (std::size_t l_lane = 0; l_lane < LANES; l_lane++)
+                            l_register[l_lane] |= l_source[l_lane];
+                    }
+                    
+                    break;
+                }
+            }
+            
+        }
+
+        // The root is always compiled last.
+        const std::uint64_t* l_root = &l_registers[(m_instructions.size() - 1) * LANES];
+
+        std::copy(l_root, l_root + l_lanes, a_outputs + l_word);
+
+    }
+    
+}
+
+std::size_t evaluator::compile(
+    const operand& a_operand,
+    std::unordered_map<const operand*, std::size_t>& a_registers
+)
+{
+    auto l_it = a_registers.find(&a_operand);
+
+    if (l_it != a_registers.end())
+        // This subterm was already compiled, reuse its register.
+        return l_it->second;
+
+    instruction l_instruction;
+
+    switch(a_operand.m_operand_type)
+    {
+        case UNRESOLVED:
+        {
+            const unresolved& l_unresolved = (const unresolved&)a_operand;
+
+            auto l_variable = std::lower_bound(m_variables.begin(), m_variables.end(), l_unresolved.m_variable);
+
+            l_instruction = { LOAD, std::size_t(l_variable - m_variables.begin()), 0 };
+            
+            break;
+        }
+        case RESOLVED:
+        {
+            const resolved& l_resolved = (const resolved&)a_operand;
+
+            l_instruction = { CONSTANT, l_resolved.m_value, 0 };
+
+            break;
+        }
+        case INVERT:
+        {
+            const invert& l_invert = (const invert&)a_operand;
+
+            l_instruction = { NOT, compile(*l_invert.m_operand, a_registers), 0 };
+
+            break;
+        }
+        case PRODUCT:
+        case SUM:
+        {
+            const operand::operand_list& l_operands = a_operand.m_operand_type == PRODUCT ?
+                ((const product&)a_operand).m_operands :
+                ((const sum&)a_operand).m_operands;
+
+            // Compile the children first, as their arguments must be contiguous.
+            std::vector<std::size_t> l_arguments;
+
+            for (const operand::ptr& l_operand : l_operands)
+                l_arguments.push_back(compile(*l_operand, a_registers));
+
+            l_instruction = {
+                a_operand.m_operand_type == PRODUCT ? AND : OR,
+                m_arguments.size(),
+                m_arguments.size() + l_arguments.size()
+            };
+
+            m_arguments.insert(m_arguments.end(), l_arguments.begin(), l_arguments.end());
+
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown operand type in evaluator::compile()");
+        }
+    }
+
+    m_instructions.push_back(l_instruction);
+
+    a_registers.insert({&a_operand, m_instructions.size() - 1});
+
+    return m_instructions.size() - 1;
+    
+}
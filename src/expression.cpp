@@ -0,0 +1,603 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/expression.hpp"
+
+using namespace ba_calculator;
+
+namespace
+{
+    // The product of two cubes which do not conflict.
+    cube conjoin(
+        const cube& a_cube_0,
+        const cube& a_cube_1
+    )
+    {
+        cube l_result = a_cube_0;
+
+        for (std::size_t i = 0; i < l_result.m_positive.size(); i++)
+        {
+            l_result.m_positive[i] |= a_cube_1.m_positive[i];
+            l_result.m_negative[i] |= a_cube_1.m_negative[i];
+        }
+
+        return l_result;
+
+    }
+
+}
+
+expression::expression(
+
+) :
+    m_root(0)
+{
+
+}
+
+expression::expression(
+    const operand::ptr& a_operand
+)
+{
+    std::unordered_map<const operand*, node> l_compiled;
+
+    m_root = compile(*a_operand, l_compiled);
+
+}
+
+operand::ptr expression::to_operand(
+
+) const
+{
+    // Built bottom-up, since every child precedes its parent.
+    std::vector<operand::ptr> l_operands(m_nodes.size(), operand::ptr(nullptr));
+
+    for (node i = 0; i <= m_root; i++)
+    {
+        const node_entry& l_entry = m_nodes[i];
+
+        switch(l_entry.m_type)
+        {
+            case UNRESOLVED:
+            {
+                l_operands[i] = operand::ptr(new unresolved(std::size_t(l_entry.m_begin)));
+                break;
+            }
+            case RESOLVED:
+            {
+                l_operands[i] = operand::ptr(new resolved(l_entry.m_begin != 0));
+                break;
+            }
+            case INVERT:
+            {
+                l_operands[i] = operand::ptr(new invert(l_operands[l_entry.m_begin]));
+                break;
+            }
+            case PRODUCT:
+            case SUM:
+            {
+                std::vector<operand::ptr> l_children;
+
+                for (std::uint32_t j = l_entry.m_begin; j < l_entry.m_end; j++)
+                    l_children.push_back(l_operands[m_children[j]]);
+
+                if (l_entry.m_type == PRODUCT)
+                    l_operands[i] = operand::ptr(new product(std::move(l_children)));
+                else
+                    l_operands[i] = operand::ptr(new sum(std::move(l_children)));
+
+                break;
+            }
+            default:
+            {
+                throw std::runtime_error("Error: unknown node type in expression::to_operand()");
+            }
+        }
+    }
+
+    return l_operands[m_root];
+
+}
+
+std::string expression::to_string(
+
+) const
+{
+    std::string l_result;
+
+    to_string(m_root, l_result);
+
+    return l_result;
+
+}
+
+expression expression::substitute(
+    const operand::substitutions& a_substitutions
+) const
+{
+    expression l_result;
+
+    std::vector<node> l_substituted(m_nodes.size(), node(-1));
+    std::unordered_map<const operand*, node> l_compiled;
+
+    l_result.m_root = l_result.substitute(*this, m_root, a_substitutions, l_substituted, l_compiled);
+
+    return l_result;
+
+}
+
+bool expression::operator<(
+    const expression& a_expression
+) const
+{
+    return compare(*this, m_root, a_expression, a_expression.m_root) < 0;
+}
+
+operand::ptr expression::reduce(
+
+) const
+{
+    // Index only the variables which actually appear.
+    std::vector<std::size_t> l_variables;
+
+    for (const node_entry& l_entry : m_nodes)
+        if (l_entry.m_type == UNRESOLVED)
+            l_variables.push_back(l_entry.m_begin);
+
+    std::sort(l_variables.begin(), l_variables.end());
+    l_variables.erase(std::unique(l_variables.begin(), l_variables.end()), l_variables.end());
+
+    cover l_cover(l_variables);
+
+    std::unordered_map<std::size_t, std::vector<cube>> l_expanded;
+
+    l_cover.m_cubes = expand(m_root, false, l_cover, l_expanded);
+
+    // An empty cover is 0, and a cover holding the empty cube is 1.
+    return l_cover.to_operand();
+
+}
+
+expression::node expression::compile(
+    const operand& a_operand,
+    std::unordered_map<const operand*, node>& a_compiled
+)
+{
+    auto l_it = a_compiled.find(&a_operand);
+
+    if (l_it != a_compiled.end())
+        return l_it->second;
+
+    node_entry l_entry{ a_operand.m_operand_type, 0, 0, std::uint32_t(a_operand.m_size) };
+
+    switch(a_operand.m_operand_type)
+    {
+        case UNRESOLVED:
+        {
+            l_entry.m_begin = std::uint32_t(((const unresolved&)a_operand).m_variable);
+            break;
+        }
+        case RESOLVED:
+        {
+            l_entry.m_begin = ((const resolved&)a_operand).m_value;
+            break;
+        }
+        case INVERT:
+        {
+            l_entry.m_begin = compile(*((const invert&)a_operand).m_operand, a_compiled);
+            break;
+        }
+        case PRODUCT:
+        case SUM:
+        {
+            const operand::operand_list& l_operands = a_operand.m_operand_type == PRODUCT ?
+                ((const product&)a_operand).m_operands :
+                ((const sum&)a_operand).m_operands;
+
+            // The operands are already in order, so they are compiled as they are.
+            std::vector<node> l_children;
+
+            for (const operand::ptr& l_operand : l_operands)
+                l_children.push_back(compile(*l_operand, a_compiled));
+
+            l_entry.m_begin = m_children.size();
+            m_children.insert(m_children.end(), l_children.begin(), l_children.end());
+            l_entry.m_end = m_children.size();
+
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown operand type in expression::compile()");
+        }
+    }
+
+    m_nodes.push_back(l_entry);
+
+    node l_result = m_nodes.size() - 1;
+
+    a_compiled[&a_operand] = l_result;
+
+    return l_result;
+
+}
+
+expression::node expression::append(
+    const operand_types& a_type,
+    std::vector<node> a_children
+)
+{
+    std::sort(
+        a_children.begin(),
+        a_children.end(),
+        [this](
+            const node& a_node_0,
+            const node& a_node_1
+        )
+        {
+            return compare(*this, a_node_0, *this, a_node_1) < 0;
+        }
+    );
+
+    a_children.erase(
+        std::unique(
+            a_children.begin(),
+            a_children.end(),
+            [this](
+                const node& a_node_0,
+                const node& a_node_1
+            )
+            {
+                return compare(*this, a_node_0, *this, a_node_1) == 0;
+            }
+        ),
+        a_children.end()
+    );
+
+    node_entry l_entry{ a_type, std::uint32_t(m_children.size()), 0, 1 };
+
+    for (const node& l_child : a_children)
+    {
+        m_children.push_back(l_child);
+        l_entry.m_size += m_nodes[l_child].m_size;
+    }
+
+    l_entry.m_end = m_children.size();
+
+    m_nodes.push_back(l_entry);
+
+    return m_nodes.size() - 1;
+
+}
+
+expression::node expression::substitute(
+    const expression& a_expression,
+    const node& a_node,
+    const operand::substitutions& a_substitutions,
+    std::vector<node>& a_substituted,
+    std::unordered_map<const operand*, node>& a_compiled
+)
+{
+    if (a_substituted[a_node] != node(-1))
+        return a_substituted[a_node];
+
+    const node_entry& l_entry = a_expression.m_nodes[a_node];
+
+    node l_result;
+
+    switch(l_entry.m_type)
+    {
+        case UNRESOLVED:
+        {
+            auto l_it = a_substitutions.find(l_entry.m_begin);
+
+            if (l_it != a_substitutions.end())
+            {
+                l_result = compile(*l_it->second, a_compiled);
+                break;
+            }
+
+            m_nodes.push_back(l_entry);
+            l_result = m_nodes.size() - 1;
+
+            break;
+        }
+        case RESOLVED:
+        {
+            m_nodes.push_back(l_entry);
+            l_result = m_nodes.size() - 1;
+
+            break;
+        }
+        case INVERT:
+        {
+            node l_child = substitute(a_expression, l_entry.m_begin, a_substitutions, a_substituted, a_compiled);
+
+            m_nodes.push_back(node_entry{ INVERT, l_child, 0, 1 + m_nodes[l_child].m_size });
+            l_result = m_nodes.size() - 1;
+
+            break;
+        }
+        case PRODUCT:
+        case SUM:
+        {
+            std::vector<node> l_children;
+
+            for (std::uint32_t i = l_entry.m_begin; i < l_entry.m_end; i++)
+                l_children.push_back(
+                    substitute(a_expression, a_expression.m_children[i], a_substitutions, a_substituted, a_compiled)
+                );
+
+            // Substituted children may fall out of order, or coincide.
+            l_result = append(l_entry.m_type, std::move(l_children));
+
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown node type in expression::substitute()");
+        }
+    }
+
+    a_substituted[a_node] = l_result;
+
+    return l_result;
+
+}
+
+int expression::compare(
+    const expression& a_expression_0,
+    const node& a_node_0,
+    const expression& a_expression_1,
+    const node& a_node_1
+)
+{
+    if (&a_expression_0 == &a_expression_1 && a_node_0 == a_node_1)
+        // Shared subterms are equal. Optimization.
+        return 0;
+
+    const node_entry& l_entry_0 = a_expression_0.m_nodes[a_node_0];
+    const node_entry& l_entry_1 = a_expression_1.m_nodes[a_node_1];
+
+    if (l_entry_0.m_type != l_entry_1.m_type)
+        // Return based on the precedence order of the operations.
+        return l_entry_0.m_type < l_entry_1.m_type ? -1 : 1;
+
+    switch(l_entry_0.m_type)
+    {
+        case UNRESOLVED:
+        case RESOLVED:
+        {
+            if (l_entry_0.m_begin != l_entry_1.m_begin)
+                return l_entry_0.m_begin < l_entry_1.m_begin ? -1 : 1;
+
+            return 0;
+        }
+        case INVERT:
+        {
+            return compare(a_expression_0, l_entry_0.m_begin, a_expression_1, l_entry_1.m_begin);
+        }
+        case PRODUCT:
+        case SUM:
+        {
+            std::uint32_t l_count_0 = l_entry_0.m_end - l_entry_0.m_begin;
+            std::uint32_t l_count_1 = l_entry_1.m_end - l_entry_1.m_begin;
+
+            if (l_count_0 != l_count_1)
+                // Take the operand count as a cue.
+                return l_count_0 < l_count_1 ? -1 : 1;
+
+            if (l_entry_0.m_size != l_entry_1.m_size)
+                // Equal subterms have equal node counts.
+                return l_entry_0.m_size < l_entry_1.m_size ? -1 : 1;
+
+            for (std::uint32_t i = 0; i < l_count_0; i++)
+            {
+                // Compare element-wise.
+                int l_result = compare(
+                    a_expression_0,
+                    a_expression_0.m_children[l_entry_0.m_begin + i],
+                    a_expression_1,
+                    a_expression_1.m_children[l_entry_1.m_begin + i]
+                );
+
+                if (l_result != 0)
+                    return l_result;
+            }
+
+            return 0;
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown node type in expression::compare()");
+        }
+    }
+
+}
+
+void expression::to_string(
+    const node& a_node,
+    std::string& a_result
+) const
+{
+    const node_entry& l_entry = m_nodes[a_node];
+
+    switch(l_entry.m_type)
+    {
+        case UNRESOLVED:
+        {
+            a_result += symbol_table::identifier(l_entry.m_begin);
+            break;
+        }
+        case RESOLVED:
+        {
+            a_result += l_entry.m_begin ? "1" : "0";
+            break;
+        }
+        case INVERT:
+        {
+            a_result += "!";
+            to_string(l_entry.m_begin, a_result);
+            break;
+        }
+        case PRODUCT:
+        case SUM:
+        {
+            // Every operand is followed by the delimiter, as operand::to_string() writes it.
+            const char* l_delimiter = l_entry.m_type == PRODUCT ? " && " : " || ";
+
+            a_result += "(";
+
+            for (std::uint32_t i = l_entry.m_begin; i < l_entry.m_end; i++)
+            {
+                to_string(m_children[i], a_result);
+                a_result += l_delimiter;
+            }
+
+            a_result += ")";
+
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown node type in expression::to_string()");
+        }
+    }
+
+}
+
+const std::vector<cube>& expression::expand(
+    const node& a_node,
+    const bool& a_is_negated,
+    cover& a_cover,
+    std::unordered_map<std::size_t, std::vector<cube>>& a_expanded
+) const
+{
+    std::size_t l_key = std::size_t(a_node) * 2 + a_is_negated;
+
+    auto l_it = a_expanded.find(l_key);
+
+    if (l_it != a_expanded.end())
+        // The subterm is shared, and was expanded already in this polarity.
+        return l_it->second;
+
+    const node_entry& l_entry = m_nodes[a_node];
+
+    std::vector<cube> l_result;
+
+    switch(l_entry.m_type)
+    {
+        case UNRESOLVED:
+        {
+            auto l_index = std::lower_bound(
+                a_cover.m_variables.begin(),
+                a_cover.m_variables.end(),
+                std::size_t(l_entry.m_begin)
+            );
+
+            cube l_cube = a_cover.make_cube();
+            l_cube.insert(l_index - a_cover.m_variables.begin(), !a_is_negated);
+
+            l_result.push_back(l_cube);
+
+            break;
+        }
+        case RESOLVED:
+        {
+            if ((l_entry.m_begin != 0) != a_is_negated)
+                // The universal cube.
+                l_result.push_back(a_cover.make_cube());
+
+            break;
+        }
+        case INVERT:
+        {
+            l_result = expand(l_entry.m_begin, !a_is_negated, a_cover, a_expanded);
+            break;
+        }
+        case PRODUCT:
+        case SUM:
+        {
+            // By De Morgan's laws, a negated product is a sum of negated
+            // operands, and a negated sum is a product of negated operands.
+            bool l_is_conjunction = (l_entry.m_type == PRODUCT) != a_is_negated;
+
+            std::vector<const std::vector<cube>*> l_operands;
+
+            for (std::uint32_t i = l_entry.m_begin; i < l_entry.m_end; i++)
+                l_operands.push_back(&expand(m_children[i], a_is_negated, a_cover, a_expanded));
+
+            if (!l_is_conjunction)
+            {
+                for (const std::vector<cube>* l_operand : l_operands)
+                    l_result.insert(l_result.end(), l_operand->begin(), l_operand->end());
+
+                break;
+            }
+
+            // Distribute the smallest operands first, so that the
+            // intermediate products stay as small as they can.
+            std::stable_sort(
+                l_operands.begin(),
+                l_operands.end(),
+                [](
+                    const std::vector<cube>* a_operand_0,
+                    const std::vector<cube>* a_operand_1
+                )
+                {
+                    return a_operand_0->size() < a_operand_1->size();
+                }
+            );
+
+            l_result.push_back(a_cover.make_cube());
+
+            const std::size_t l_budget = product::distribution_budget();
+
+            for (const std::vector<cube>* l_operand : l_operands)
+            {
+                // As in product::expand(), a budget of zero lifts the limit.
+                std::size_t l_estimate = saturating_multiply(l_result.size(), l_operand->size());
+
+                if (l_budget != 0 && l_estimate > l_budget)
+                    throw distribution_budget_exceeded(l_estimate, l_budget);
+
+                // Conflicts and pruning usually leave far fewer cubes than the
+                // estimate, so the result grows as it goes rather than reserving it.
+                std::vector<cube> l_distributed;
+
+                for (const cube& l_cube_0 : l_result)
+                    for (const cube& l_cube_1 : *l_operand)
+                        if (!l_cube_0.conflicts(l_cube_1))
+                            l_distributed.push_back(conjoin(l_cube_0, l_cube_1));
+
+                l_result.swap(l_distributed);
+
+                if (l_result.empty())
+                    // A contradiction absorbs the whole product.
+                    break;
+
+                // Prune along the way, so that each step distributes as few cubes as it can.
+                a_cover.m_cubes.swap(l_result);
+                a_cover.prune();
+                a_cover.m_cubes.swap(l_result);
+
+            }
+
+            break;
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown node type in expression::expand()");
+        }
+    }
+
+    a_cover.m_cubes.swap(l_result);
+    a_cover.prune();
+    a_cover.m_cubes.swap(l_result);
+
+    return a_expanded[l_key] = std::move(l_result);
+
+}
@@ -21,7 +21,10 @@ invert::invert(
     operand(INVERT),
     m_operand(a_operand)
 {
-
+    m_hash = combine_hash(m_hash, a_operand->m_hash);
+    m_size += a_operand->m_size;
+    m_depth += a_operand->m_depth;
+    merge_support(*a_operand);
 }
 
 operand::ptr invert::reduce_operands(
@@ -39,7 +42,7 @@ operand::ptr invert::simplify(
     {
         case UNRESOLVED:
         {
-            return ptr((operand*)this);
+            return self();
         }
         case RESOLVED:
         {
@@ -54,11 +57,11 @@ operand::ptr invert::simplify(
         }
         case PRODUCT:
         {
-            return ptr((operand*)this);
+            return self();
         }
         case SUM:
         {
-            return ptr((operand*)this);
+            return self();
         }
         default:
         {
@@ -75,7 +78,7 @@ operand::ptr invert::expand(
     {
         case UNRESOLVED:
         {
-            return ptr((operand*)this);
+            return self();
         }
         case RESOLVED:
         {
@@ -96,12 +99,12 @@ operand::ptr invert::expand(
 
             product* l_product = (product*)m_operand.get();
 
-            std::set<ptr> l_result_operands;
+            std::vector<ptr> l_result_operands;
 
             std::transform(
                 l_product->m_operands.begin(),
                 l_product->m_operands.end(),
-                std::inserter(l_result_operands, l_result_operands.begin()),
+                std::back_inserter(l_result_operands),
                 [](
                     const ptr& a_child_operand
                 )
@@ -110,7 +113,7 @@ operand::ptr invert::expand(
                 }
             );
 
-            ptr l_result = ptr(new sum(l_result_operands));
+            ptr l_result = ptr(new sum(std::move(l_result_operands)));
 
             return l_result->reduce();
             
@@ -121,21 +124,44 @@ operand::ptr invert::expand(
             
             sum* l_sum = (sum*)m_operand.get();
 
-            std::set<ptr> l_result_operands;
+            std::vector<ptr> l_result_operands;
 
             std::transform(
                 l_sum->m_operands.begin(),
                 l_sum->m_operands.end(),
-                std::inserter(l_result_operands, l_result_operands.begin()),
+                std::back_inserter(l_result_operands),
                 [](
                     const ptr& a_child_operand
                 )
                 {
-                    return ptr(new invert(a_child_operand));
+                    if (a_child_operand->m_operand_type != PRODUCT)
+                        return ptr(new invert(a_child_operand));
+
+                    // Apply demorgan's a second time to the child product right away.
+                    // Inverting the product as a whole would only reduce it back
+                    // into an inverted sum, which would never terminate.
+                    const product* l_product = (const product*)a_child_operand.get();
+
+                    std::vector<ptr> l_inverted_literals;
+
+                    std::transform(
+                        l_product->m_operands.begin(),
+                        l_product->m_operands.end(),
+                        std::back_inserter(l_inverted_literals),
+                        [](
+                            const ptr& a_literal
+                        )
+                        {
+                            return ptr(new invert(a_literal));
+                        }
+                    );
+
+                    return ptr(new sum(std::move(l_inverted_literals)));
+                    
                 }
             );
 
-            ptr l_result = ptr(new product(l_result_operands));
+            ptr l_result = ptr(new product(std::move(l_result_operands)));
 
             return l_result->reduce();
             
@@ -149,13 +175,20 @@ operand::ptr invert::expand(
 }
 
 operand::ptr invert::substitute(
-    const std::string& a_identifier,
-    const ptr& a_operand
+    const substitutions& a_substitutions
 ) const
 {
-    return ptr(new invert(
-        m_operand->substitute(a_identifier, a_operand)
-    ));
+    if (!depends_on(a_substitutions))
+        // None of the bound variables appear beneath this operand.
+        return self();
+
+    ptr l_operand = m_operand->substitute(a_substitutions);
+
+    if (l_operand.get() == m_operand.get())
+        // Nothing was bound beneath this operand, so avoid rebuilding it.
+        return self();
+
+    return ptr(new invert(l_operand));
 }
 
 std::string invert::to_string(
@@ -177,3 +210,16 @@ bool invert::operator<(
     return m_operand.operator<(l_invert.m_operand);
     
 }
+
+bool invert::shallow_equals(
+    const operand& a_operand
+) const
+{
+    if (a_operand.m_operand_type != m_operand_type)
+        return false;
+
+    const invert& l_invert = (const invert&)a_operand;
+
+    return m_operand.get() == l_invert.m_operand.get();
+    
+}
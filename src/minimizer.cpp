@@ -0,0 +1,605 @@
+#include <algorithm>
+#include <bit>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+#include <atomic>
+#include <map>
+#include <thread>
+
+#include "include/minimizer.hpp"
+
+using namespace ba_calculator;
+
+operand::ptr minimizer::heuristic(
+    const operand::ptr& a_operand
+)
+{
+    return heuristic(cover::of(a_operand)).to_operand();
+}
+
+cover minimizer::heuristic(
+    const cover& a_cover
+)
+{
+    cover l_best = a_cover;
+
+    expand(l_best);
+    irredundant(l_best);
+
+    while (true)
+    {
+        cover l_candidate = l_best;
+
+        reduce(l_candidate);
+        expand(l_candidate);
+        irredundant(l_candidate);
+
+        if (!is_cheaper(l_candidate, l_best))
+            // The loop has converged.
+            break;
+
+        l_best = l_candidate;
+        
+    }
+
+    return l_best;
+    
+}
+
+operand::ptr minimizer::exact(
+    const operand::ptr& a_operand,
+    const std::size_t& a_thread_count
+)
+{
+    return exact(cover::of(a_operand), a_thread_count).to_operand();
+}
+
+cover minimizer::exact(
+    const cover& a_cover,
+    const std::size_t& a_thread_count
+)
+{
+    std::size_t l_variable_count = a_cover.m_variables.size();
+
+    if (l_variable_count > MAX_EXACT_VARIABLES)
+        throw std::runtime_error("Error: too many variables for minimizer::exact()");
+
+    std::size_t l_thread_count = a_thread_count != 0 ?
+        a_thread_count :
+        scheduler::thread_count();
+
+    // Enumerate the minterms of each cube, by walking every subset of its free variables.
+    std::uint64_t l_all = l_variable_count == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << l_variable_count) - 1;
+
+    std::vector<implicant> l_minterms;
+
+    for (const cube& l_cube : a_cover.m_cubes)
+    {
+        std::uint64_t l_positive = l_cube.m_positive.empty() ? 0 : l_cube.m_positive[0];
+        std::uint64_t l_negative = l_cube.m_negative.empty() ? 0 : l_cube.m_negative[0];
+        std::uint64_t l_free = l_all & ~(l_positive | l_negative);
+
+        for (std::uint64_t l_subset = l_free;; l_subset = (l_subset - 1) & l_free)
+        {
+            l_minterms.push_back({ l_positive | l_subset, l_all });
+
+            if (l_subset == 0)
+                break;
+        }
+    }
+
+    std::sort(l_minterms.begin(), l_minterms.end());
+    l_minterms.erase(std::unique(l_minterms.begin(), l_minterms.end()), l_minterms.end());
+
+    std::vector<implicant> l_primes = prime_implicants(l_minterms, l_thread_count);
+
+    cover l_result(a_cover.m_variables);
+
+    for (const implicant& l_implicant : select_cover(l_primes, l_minterms))
+    {
+        cube l_cube = l_result.make_cube();
+
+        for (std::size_t i = 0; i < l_variable_count; i++)
+            if ((l_implicant.m_mask >> i) & 1)
+                l_cube.insert(i, (l_implicant.m_value >> i) & 1);
+
+        l_result.m_cubes.push_back(l_cube);
+        
+    }
+
+    return l_result;
+    
+}
+
+bool minimizer::is_tautology(
+    const std::vector<cube>& a_cubes
+)
+{
+    if (a_cubes.empty())
+        return false;
+
+    for (const cube& l_cube : a_cubes)
+        if (l_cube.literal_count() == 0)
+            // The universal cube alone makes the sum 1.
+            return true;
+
+    std::size_t l_words = a_cubes.front().m_positive.size();
+
+    // Find the variables which appear in both polarities.
+    std::vector<std::uint64_t> l_binate(l_words);
+
+    for (std::size_t i = 0; i < l_words; i++)
+    {
+        std::uint64_t l_positive = 0;
+        std::uint64_t l_negative = 0;
+
+        for (const cube& l_cube : a_cubes)
+        {
+            l_positive |= l_cube.m_positive[i];
+            l_negative |= l_cube.m_negative[i];
+        }
+
+        l_binate[i] = l_positive & l_negative;
+        
+    }
+
+    // Split on the binate variable which appears in the most cubes.
+    std::size_t l_split = 0;
+    std::size_t l_split_count = 0;
+
+    for (std::size_t i = 0; i < l_words; i++)
+    {
+        for (std::uint64_t l_bits = l_binate[i]; l_bits != 0; l_bits &= l_bits - 1)
+        {
+            std::size_t l_bit = std::countr_zero(l_bits);
+            std::size_t l_count = 0;
+
+            for (const cube& l_cube : a_cubes)
+                l_count += ((l_cube.m_positive[i] | l_cube.m_negative[i]) >> l_bit) & 1;
+
+            if (l_count > l_split_count)
+            {
+                l_split = i * 64 + l_bit;
+                l_split_count = l_count;
+            }
+        }
+    }
+
+    if (l_split_count == 0)
+        // A unate cover is 1 only if it holds the universal cube, which it does not.
+        return false;
+
+    cube l_positive(l_words * 64);
+    l_positive.insert(l_split, true);
+
+    cube l_negative(l_words * 64);
+    l_negative.insert(l_split, false);
+
+    return
+        is_tautology(cofactor(a_cubes, l_positive)) &&
+        is_tautology(cofactor(a_cubes, l_negative));
+    
+}
+
+bool minimizer::is_covered(
+    const std::vector<cube>& a_cubes,
+    const cube& a_cube
+)
+{
+    return is_tautology(cofactor(a_cubes, a_cube));
+}
+
+std::vector<cube> minimizer::cofactor(
+    const std::vector<cube>& a_cubes,
+    const cube& a_cube
+)
+{
+    std::vector<cube> l_result;
+
+    for (const cube& l_cube : a_cubes)
+    {
+        if (l_cube.conflicts(a_cube))
+            continue;
+
+        cube l_cofactor = l_cube;
+
+        for (std::size_t i = 0; i < l_cofactor.m_positive.size(); i++)
+        {
+            l_cofactor.m_positive[i] &= ~a_cube.m_positive[i];
+            l_cofactor.m_negative[i] &= ~a_cube.m_negative[i];
+        }
+
+        l_result.push_back(l_cofactor);
+        
+    }
+
+    return l_result;
+    
+}
+
+void minimizer::expand(
+    cover& a_cover
+)
+{
+    // Expand the largest cubes first, as they are the likeliest to absorb others.
+    std::stable_sort(
+        a_cover.m_cubes.begin(),
+        a_cover.m_cubes.end(),
+        [](
+            const cube& a_cube_0,
+            const cube& a_cube_1
+        )
+        {
+            return a_cube_0.literal_count() < a_cube_1.literal_count();
+        }
+    );
+
+    for (std::size_t i = 0; i < a_cover.m_cubes.size(); i++)
+    {
+        cube l_cube = a_cover.m_cubes[i];
+
+        for (std::size_t l_variable = 0; l_variable < a_cover.m_variables.size(); l_variable++)
+        {
+            for (const bool l_polarity : { true, false })
+            {
+                if (!l_cube.contains(l_variable, l_polarity))
+                    continue;
+
+                cube l_raised = l_cube;
+                l_raised.erase(l_variable, l_polarity);
+
+                // The raised cube must remain inside the function.
+                if (is_covered(a_cover.m_cubes, l_raised))
+                    l_cube = l_raised;
+            }
+        }
+
+        a_cover.m_cubes[i] = l_cube;
+
+        // Drop the cubes which the expanded cube now covers, keeping track
+        // of where the expanded cube itself ends up.
+        std::vector<cube> l_remaining;
+        std::size_t l_position = 0;
+
+        for (std::size_t j = 0; j < a_cover.m_cubes.size(); j++)
+        {
+            if (j != i && l_cube.covers(a_cover.m_cubes[j]))
+                continue;
+
+            if (j == i)
+                l_position = l_remaining.size();
+
+            l_remaining.push_back(a_cover.m_cubes[j]);
+        }
+
+        a_cover.m_cubes.swap(l_remaining);
+
+        i = l_position;
+        
+    }
+    
+}
+
+void minimizer::irredundant(
+    cover& a_cover
+)
+{
+    // Try to drop the smallest cubes first, as they contribute the most literals.
+    std::stable_sort(
+        a_cover.m_cubes.begin(),
+        a_cover.m_cubes.end(),
+        [](
+            const cube& a_cube_0,
+            const cube& a_cube_1
+        )
+        {
+            return a_cube_0.literal_count() > a_cube_1.literal_count();
+        }
+    );
+
+    for (std::size_t i = 0; i < a_cover.m_cubes.size();)
+    {
+        std::vector<cube> l_others = a_cover.m_cubes;
+        l_others.erase(l_others.begin() + i);
+
+        if (is_covered(l_others, a_cover.m_cubes[i]))
+        {
+            a_cover.m_cubes.swap(l_others);
+            continue;
+        }
+
+        i++;
+        
+    }
+    
+}
+
+void minimizer::reduce(
+    cover& a_cover
+)
+{
+    for (std::size_t i = 0; i < a_cover.m_cubes.size(); i++)
+    {
+        std::vector<cube> l_others = a_cover.m_cubes;
+        l_others.erase(l_others.begin() + i);
+
+        cube& l_cube = a_cover.m_cubes[i];
+
+        for (std::size_t l_variable = 0; l_variable < a_cover.m_variables.size(); l_variable++)
+        {
+            if (l_cube.contains(l_variable, true) || l_cube.contains(l_variable, false))
+                continue;
+
+            for (const bool l_polarity : { true, false })
+            {
+                // Lowering the cube into one polarity gives up its other half,
+                // which is fine only if the rest of the cover already implies it.
+                cube l_given_up = l_cube;
+                l_given_up.insert(l_variable, !l_polarity);
+
+                if (!is_covered(l_others, l_given_up))
+                    continue;
+
+                l_cube.insert(l_variable, l_polarity);
+                break;
+            }
+        }
+        
+    }
+    
+}
+
+std::vector<minimizer::implicant> minimizer::prime_implicants(
+    const std::vector<implicant>& a_minterms,
+    const std::size_t& a_thread_count
+)
+{
+    std::vector<implicant> l_primes;
+    std::vector<implicant> l_current = a_minterms;
+
+    while (!l_current.empty())
+    {
+        // Group the implicants by their mask, and then by the popcount of their
+        // value. Only implicants in adjacent groups of the same mask can combine.
+        std::map<std::pair<std::uint64_t, std::size_t>, std::vector<std::size_t>> l_groups;
+
+        for (std::size_t i = 0; i < l_current.size(); i++)
+            l_groups[{ l_current[i].m_mask, std::popcount(l_current[i].m_value) }].push_back(i);
+
+        std::vector<std::pair<const std::vector<std::size_t>*, const std::vector<std::size_t>*>> l_tasks;
+
+        for (const auto& [l_key, l_group] : l_groups)
+        {
+            auto l_next = l_groups.find({ l_key.first, l_key.second + 1 });
+
+            if (l_next != l_groups.end())
+                l_tasks.push_back({ &l_group, &l_next->second });
+        }
+
+        // Each job claims pairs of groups until none remain, and keeps
+        // its results local until every job is done.
+        std::atomic<std::size_t> l_next_task(0);
+
+        const std::size_t l_job_count = std::max<std::size_t>(1, std::min(a_thread_count, l_tasks.size()));
+
+        std::vector<std::vector<implicant>> l_combined(l_job_count);
+        std::vector<std::vector<std::size_t>> l_used(l_job_count);
+
+        auto l_worker = [&](
+            const std::size_t& a_job
+        )
+        {
+            for (std::size_t l_task = l_next_task++; l_task < l_tasks.size(); l_task = l_next_task++)
+            {
+                for (const std::size_t& l_index_0 : *l_tasks[l_task].first)
+                {
+                    for (const std::size_t& l_index_1 : *l_tasks[l_task].second)
+                    {
+                        const implicant& l_implicant_0 = l_current[l_index_0];
+                        const implicant& l_implicant_1 = l_current[l_index_1];
+
+                        std::uint64_t l_difference = l_implicant_0.m_value ^ l_implicant_1.m_value;
+
+                        if (std::popcount(l_difference) != 1)
+                            continue;
+
+                        l_combined[a_job].push_back({
+                            l_implicant_0.m_value & ~l_difference,
+                            l_implicant_0.m_mask & ~l_difference
+                        });
+
+                        l_used[a_job].push_back(l_index_0);
+                        l_used[a_job].push_back(l_index_1);
+                    }
+                }
+            }
+        };
+
+        // The jobs run on the scheduler's pool, as product::distribute() does.
+        std::vector<std::function<void()>> l_jobs;
+
+        for (std::size_t i = 0; i < l_job_count; i++)
+            l_jobs.push_back([&l_worker, i]() { l_worker(i); });
+
+        scheduler::run(l_jobs);
+
+        // Merge the per-job results.
+        std::vector<bool> l_is_used(l_current.size());
+        std::vector<implicant> l_next;
+
+        for (std::size_t i = 0; i < l_job_count; i++)
+        {
+            for (const std::size_t& l_index : l_used[i])
+                l_is_used[l_index] = true;
+
+            l_next.insert(l_next.end(), l_combined[i].begin(), l_combined[i].end());
+        }
+
+        // Whatever did not combine with anything is prime.
+        for (std::size_t i = 0; i < l_current.size(); i++)
+            if (!l_is_used[i])
+                l_primes.push_back(l_current[i]);
+
+        std::sort(l_next.begin(), l_next.end());
+        l_next.erase(std::unique(l_next.begin(), l_next.end()), l_next.end());
+
+        l_current.swap(l_next);
+        
+    }
+
+    std::sort(l_primes.begin(), l_primes.end());
+
+    return l_primes;
+    
+}
+
+std::vector<minimizer::implicant> minimizer::select_cover(
+    const std::vector<implicant>& a_primes,
+    const std::vector<implicant>& a_minterms
+)
+{
+    std::vector<std::vector<std::size_t>> l_primes_of_minterm(a_minterms.size());
+    std::vector<std::vector<std::size_t>> l_minterms_of_prime(a_primes.size());
+
+    for (std::size_t i = 0; i < a_minterms.size(); i++)
+    {
+        for (std::size_t j = 0; j < a_primes.size(); j++)
+        {
+            if ((a_minterms[i].m_value & a_primes[j].m_mask) != a_primes[j].m_value)
+                continue;
+
+            l_primes_of_minterm[i].push_back(j);
+            l_minterms_of_prime[j].push_back(i);
+        }
+    }
+
+    std::vector<std::size_t> l_times_covered(a_minterms.size());
+    std::vector<std::size_t> l_chosen;
+
+    // Every prime together is always a cover, so start the bound from there.
+    std::vector<std::size_t> l_best(a_primes.size());
+    std::size_t l_best_literals = 0;
+
+    for (std::size_t i = 0; i < a_primes.size(); i++)
+    {
+        l_best[i] = i;
+        l_best_literals += std::popcount(a_primes[i].m_mask);
+    }
+
+    select_cover(
+        a_primes,
+        l_primes_of_minterm,
+        l_minterms_of_prime,
+        l_times_covered,
+        l_chosen,
+        l_best,
+        l_best_literals
+    );
+
+    std::vector<implicant> l_result;
+
+    for (const std::size_t& l_index : l_best)
+        l_result.push_back(a_primes[l_index]);
+
+    return l_result;
+    
+}
+
+void minimizer::select_cover(
+    const std::vector<implicant>& a_primes,
+    const std::vector<std::vector<std::size_t>>& a_primes_of_minterm,
+    const std::vector<std::vector<std::size_t>>& a_minterms_of_prime,
+    std::vector<std::size_t>& a_times_covered,
+    std::vector<std::size_t>& a_chosen,
+    std::vector<std::size_t>& a_best,
+    std::size_t& a_best_literals
+)
+{
+    // Branch on the uncovered minterm with the fewest primes covering it.
+    // Minterms covered by a single prime make that prime essential.
+    std::size_t l_minterm = a_times_covered.size();
+
+    for (std::size_t i = 0; i < a_times_covered.size(); i++)
+        if (a_times_covered[i] == 0 &&
+            (l_minterm == a_times_covered.size() || a_primes_of_minterm[i].size() < a_primes_of_minterm[l_minterm].size()))
+            l_minterm = i;
+
+    if (l_minterm == a_times_covered.size())
+    {
+        // Everything is covered, keep this selection if it is cheaper.
+        std::size_t l_literals = 0;
+
+        for (const std::size_t& l_index : a_chosen)
+            l_literals += std::popcount(a_primes[l_index].m_mask);
+
+        if (a_chosen.size() < a_best.size() || (a_chosen.size() == a_best.size() && l_literals < a_best_literals))
+        {
+            a_best = a_chosen;
+            a_best_literals = l_literals;
+        }
+
+        return;
+        
+    }
+
+    if (a_chosen.size() + 1 > a_best.size())
+        // At least one more prime is needed, which cannot beat the best.
+        return;
+
+    for (const std::size_t& l_prime : a_primes_of_minterm[l_minterm])
+    {
+        for (const std::size_t& l_covered : a_minterms_of_prime[l_prime])
+            a_times_covered[l_covered]++;
+
+        a_chosen.push_back(l_prime);
+
+        select_cover(
+            a_primes,
+            a_primes_of_minterm,
+            a_minterms_of_prime,
+            a_times_covered,
+            a_chosen,
+            a_best,
+            a_best_literals
+        );
+
+        a_chosen.pop_back();
+
+        for (const std::size_t& l_covered : a_minterms_of_prime[l_prime])
+            a_times_covered[l_covered]--;
+        
+    }
+    
+}
+
+bool minimizer::implicant::operator<(
+    const implicant& a_implicant
+) const
+{
+    if (m_mask != a_implicant.m_mask)
+        return m_mask < a_implicant.m_mask;
+
+    return m_value < a_implicant.m_value;
+    
+}
+
+bool minimizer::implicant::operator==(
+    const implicant& a_implicant
+) const
+{
+    return m_mask == a_implicant.m_mask && m_value == a_implicant.m_value;
+}
+
+bool minimizer::is_cheaper(
+    const cover& a_cover_0,
+    const cover& a_cover_1
+)
+{
+    if (a_cover_0.m_cubes.size() != a_cover_1.m_cubes.size())
+        return a_cover_0.m_cubes.size() < a_cover_1.m_cubes.size();
+
+    return a_cover_0.literal_count() < a_cover_1.literal_count();
+    
+}
@@ -5,11 +5,128 @@
 #include <assert.h>
 
 #include "include/calculator.hpp"
+#include "include/bdd.hpp"
+#include "include/expression.hpp"
 
 using namespace ba_calculator;
 
+namespace
+{
+    operand::ptr cofactor(
+        const operand::ptr& a_operand,
+        const std::size_t& a_variable,
+        const bool& a_value,
+        std::unordered_map<const operand*, operand::ptr>& a_cofactors
+    )
+    {
+        const std::vector<std::size_t>& l_support = a_operand->support();
+
+        if (!std::binary_search(l_support.begin(), l_support.end(), a_variable))
+            // The variable does not appear beneath this operand.
+            return a_operand;
+
+        auto l_it = a_cofactors.find(a_operand.get());
+
+        if (l_it != a_cofactors.end())
+            return l_it->second;
+
+        operand::ptr l_result(nullptr);
+
+        switch(a_operand->m_operand_type)
+        {
+            case UNRESOLVED:
+            {
+                l_result = operand::ptr(new resolved(a_value));
+                break;
+            }
+            case INVERT:
+            {
+                operand::ptr l_operand = cofactor(((const invert&)*a_operand).m_operand, a_variable, a_value, a_cofactors);
+
+                if (l_operand->m_operand_type == RESOLVED)
+                    l_result = operand::ptr(new resolved(!((const resolved&)*l_operand).m_value));
+                else if (l_operand->m_operand_type == INVERT)
+                    l_result = ((const invert&)*l_operand).m_operand;
+                else
+                    l_result = operand::ptr(new invert(l_operand));
+
+                break;
+            }
+            case PRODUCT:
+            case SUM:
+            {
+                // 0 absorbs a product and 1 absorbs a sum, while the other is dropped.
+                bool l_absorbing = a_operand->m_operand_type == SUM;
+
+                const operand::operand_list& l_operands = a_operand->m_operand_type == PRODUCT ?
+                    ((const product&)*a_operand).m_operands :
+                    ((const sum&)*a_operand).m_operands;
+
+                std::vector<operand::ptr> l_kept;
+
+                for (const operand::ptr& l_operand : l_operands)
+                {
+                    operand::ptr l_cofactor = cofactor(l_operand, a_variable, a_value, a_cofactors);
+
+                    if (l_cofactor->m_operand_type != RESOLVED)
+                    {
+                        l_kept.push_back(l_cofactor);
+                        continue;
+                    }
+
+                    if (((const resolved&)*l_cofactor).m_value == l_absorbing)
+                    {
+                        l_result = l_cofactor;
+                        break;
+                    }
+                }
+
+                if (l_result)
+                    break;
+
+                if (l_kept.empty())
+                    l_result = operand::ptr(new resolved(!l_absorbing));
+                else if (l_kept.size() == 1)
+                    l_result = l_kept[0];
+                else if (a_operand->m_operand_type == PRODUCT)
+                    l_result = operand::ptr(new product(std::move(l_kept)));
+                else
+                    l_result = operand::ptr(new sum(std::move(l_kept)));
+
+                break;
+            }
+            default:
+            {
+                throw std::runtime_error("Error: unknown operand type in operand::cofactor()");
+            }
+        }
+
+        a_cofactors.emplace(a_operand.get(), l_result);
+
+        return l_result;
+
+    }
+
+}
+
+operand::ptr::ptr(
+    std::nullptr_t a_null
+) :
+    std::shared_ptr<operand>(a_null)
+{
+
+}
+
 operand::ptr::ptr(
     operand* a_operand
+) :
+    std::shared_ptr<operand>(unique_table::intern(a_operand))
+{
+
+}
+
+operand::ptr::ptr(
+    const std::shared_ptr<operand>& a_operand
 ) :
     std::shared_ptr<operand>(a_operand)
 {
@@ -20,56 +137,277 @@ bool operand::ptr::operator<(
     const ptr& a_operand
 ) const
 {
+    if (get() == a_operand.get())
+        // Interned operands which share an address are equal. Optimization.
+        return false;
+        
     return get()->operator<(*a_operand);
 }
 
+operand::~operand(
+
+)
+{
+    if (m_is_interned)
+        unique_table::erase(this);
+}
+
 operand::operand(
     const operand_types& a_operand_type
 ) :
     m_operand_type(a_operand_type),
-    m_is_reduced(false)
+    m_hash(std::hash<int>()(a_operand_type)),
+    m_size(1),
+    m_depth(1),
+    m_is_interned(false)
+{
+
+}
+
+void* operand::operator new(
+    std::size_t a_size
+)
+{
+    return arena::allocate(a_size);
+}
+
+void operand::operator delete(
+    void* a_pointer
+)
 {
+    arena::deallocate(a_pointer);
+}
+
+void operand::merge_support(
+    const operand& a_operand
+)
+{
+    if (a_operand.m_support.empty())
+        return;
+        
+    std::vector<std::size_t> l_merged;
+
+    l_merged.reserve(m_support.size() + a_operand.m_support.size());
 
+    std::set_union(
+        m_support.begin(),
+        m_support.end(),
+        a_operand.m_support.begin(),
+        a_operand.m_support.end(),
+        std::back_inserter(l_merged)
+    );
+
+    m_support.swap(l_merged);
+    
+}
+
+operand::ptr operand::self(
+
+) const
+{
+    return ptr(std::const_pointer_cast<operand>(shared_from_this()));
+}
+
+std::size_t operand::combine_hash(
+    const std::size_t& a_seed,
+    const std::size_t& a_value
+)
+{
+    return a_seed ^ (a_value + 0x9e3779b97f4a7c15ULL + (a_seed << 6) + (a_seed >> 2));
+}
+
+std::vector<operand::ptr> operand::reduce_each(
+    const operand_list& a_operands
+)
+{
+    std::vector<ptr> l_results(a_operands.size(), ptr(nullptr));
+
+    // The first job reduces the small operands inline, and every
+    // large operand is reduced by a job of its own.
+    std::vector<std::size_t> l_small;
+    std::vector<std::function<void()>> l_jobs(1);
+
+    for (std::size_t i = 0; i < a_operands.size(); i++)
+    {
+        if (!scheduler::is_parallel() || a_operands[i]->m_size < PARALLEL_REDUCE_THRESHOLD)
+        {
+            l_small.push_back(i);
+            continue;
+        }
+
+        l_jobs.push_back(
+            [&a_operands, &l_results, i]()
+            {
+                l_results[i] = a_operands[i]->reduce();
+            }
+        );
+    }
+
+    l_jobs[0] = [&a_operands, &l_results, &l_small]()
+    {
+        for (const std::size_t& i : l_small)
+            l_results[i] = a_operands[i]->reduce();
+    };
+
+    if (l_jobs.size() == 1)
+        l_jobs[0]();
+    else
+        scheduler::run(l_jobs);
+
+    return l_results;
+    
 }
 
 operand::ptr operand::reduce_operands(
 
 ) const
 {
-    return ptr((operand*)this);
+    return self();
 }
 
 operand::ptr operand::simplify(
     
 ) const
 {
-    return ptr((operand*)this);
+    return self();
 }
 
 operand::ptr operand::expand(
 
 ) const
 {
-    return ptr((operand*)this);
+    return self();
 }
 
 operand::ptr operand::reduce(
 
 ) const
 {
-    if (m_is_reduced)
-        // If the operand is already reduced, do nothing. Optimization.
-        return ptr((operand*)this);
+    ptr l_self = self();
+
+    // The same subterm may have been reduced already under a different parent,
+    // or may itself be the result of an earlier reduction.
+    ptr l_result = reduce_cache::find(l_self);
 
-    ptr l_result = reduce_operands()->simplify()->expand();
+    if (l_result)
+        return l_result;
 
-    // Enable the flag so as to allow for optimization condition to be satisfied.
-    l_result->m_is_reduced = true;
+    l_result = reduce_operands()->simplify()->expand();
+
+    reduce_cache::insert(l_self, l_result);
+
+    // The result reduces to itself. Recording that in the cache, rather than on
+    // the result, keeps shared operands untouched once built.
+    reduce_cache::insert(l_result, l_result);
 
     return l_result;
     
 }
 
+const std::vector<std::size_t>& operand::support(
+
+) const
+{
+    return m_support;
+}
+
+bool operand::depends_on(
+    const substitutions& a_substitutions
+) const
+{
+    if (m_support.size() <= a_substitutions.size())
+        return std::any_of(
+            m_support.begin(),
+            m_support.end(),
+            [&a_substitutions](
+                const std::size_t& a_variable
+            )
+            {
+                return a_substitutions.count(a_variable) > 0;
+            }
+        );
+
+    return std::any_of(
+        a_substitutions.begin(),
+        a_substitutions.end(),
+        [this](
+            const substitutions::value_type& a_substitution
+        )
+        {
+            return std::binary_search(m_support.begin(), m_support.end(), a_substitution.first);
+        }
+    );
+    
+}
+
+operand::ptr operand::substitute(
+    const std::string& a_identifier,
+    const ptr& a_operand
+) const
+{
+    std::size_t l_variable = symbol_table::find(a_identifier);
+
+    if (l_variable == symbol_table::npos)
+        // No operand has ever referred to this identifier, so nothing can change.
+        return self();
+
+    return substitute(l_variable, a_operand);
+    
+}
+
+operand::ptr operand::substitute(
+    const std::size_t& a_variable,
+    const ptr& a_operand
+) const
+{
+    return substitute(substitutions({{a_variable, a_operand}}));
+}
+
+operand::ptr operand::cofactor(
+    const std::size_t& a_variable,
+    const bool& a_value
+) const
+{
+    std::unordered_map<const operand*, ptr> l_cofactors;
+
+    return ::cofactor(self(), a_variable, a_value, l_cofactors);
+
+}
+
+operand::ptr operand::reduce(
+    const reduction_strategies& a_strategy
+) const
+{
+    switch(a_strategy)
+    {
+        case EXPANSION:
+        {
+            return reduce();
+        }
+        case PARALLEL_EXPANSION:
+        {
+            scheduler::scope l_scope;
+            return reduce();
+        }
+        case DECISION_DIAGRAM:
+        {
+            ptr l_self = self();
+
+            bdd_manager l_manager(bdd_manager::depth_first_order(l_self));
+
+            return l_manager.to_operand(l_manager.build(l_self));
+        }
+        case TAGGED_EXPANSION:
+        {
+            return expression(self()).reduce();
+        }
+        default:
+        {
+            throw std::runtime_error("Error: unknown reduction strategy in operand::reduce()");
+        }
+    }
+}
+
 bool operand::operator<(
     const operand& a_operand
 ) const
@@ -82,5 +420,15 @@ bool operand::operator==(
     const operand& a_operand
 ) const
 {
+    if (this == &a_operand)
+        return true;
+
+    if (m_is_interned && a_operand.m_is_interned)
+        // Two distinct canonical instances can never be structurally equal.
+        return false;
+
+    if (m_hash != a_operand.m_hash)
+        return false;
+    
     return !operator<(a_operand) && !a_operand.operator<(*this);
 }
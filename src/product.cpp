@@ -1,13 +1,44 @@
 #include <algorithm>
 #include <deque>
 #include <iterator>
+#include <limits>
+#include <queue>
 #include <sstream>
 #include <assert.h>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
 
 #include "include/calculator.hpp"
 
 using namespace ba_calculator;
 
+std::size_t ba_calculator::saturating_multiply(
+    const std::size_t& a_value_0,
+    const std::size_t& a_value_1
+)
+{
+    if (a_value_0 != 0 && a_value_1 > std::numeric_limits<std::size_t>::max() / a_value_0)
+        return std::numeric_limits<std::size_t>::max();
+
+    return a_value_0 * a_value_1;
+}
+
+distribution_budget_exceeded::distribution_budget_exceeded(
+    const std::size_t& a_estimate,
+    const std::size_t& a_budget
+) :
+    std::runtime_error(
+        "Error: distributing " + std::to_string(a_estimate) +
+        " products exceeds the budget of " + std::to_string(a_budget) +
+        " in product::expand()"
+    ),
+    m_estimate(a_estimate),
+    m_budget(a_budget)
+{
+
+}
+
 product::~product(
 
 )
@@ -16,50 +47,41 @@ product::~product(
 }
 
 product::product(
-    const std::set<ptr>& a_operands
+    operand_list a_operands
 ) :
     operand(PRODUCT),
-    m_operands(a_operands)
+    m_operands(std::move(a_operands))
 {
-
+    for (const ptr& l_operand : m_operands)
+    {
+        m_hash = combine_hash(m_hash, l_operand->m_hash);
+        m_size += l_operand->m_size;
+        m_depth = std::max(m_depth, l_operand->m_depth + 1);
+        merge_support(*l_operand);
+    }
 }
 
 operand::ptr product::reduce_operands(
 
 ) const
 {
-    std::set<ptr> l_result_operands;
-
-    std::transform(
-        m_operands.begin(),
-        m_operands.end(),
-        std::inserter(l_result_operands, l_result_operands.begin()),
-        [](
-            const ptr& a_operand
-        )
-        {
-            return a_operand->reduce();
-        }
-    );
-
-    return ptr(new product(l_result_operands));
-    
+    return ptr(new product(reduce_each(m_operands)));
 }
 
 operand::ptr product::simplify(
 
 ) const
 {
-
+    return self();
 }
 
 operand::ptr product::expand(
 
 ) const
 {
-    // Initialize the foremost_product_operands vector to contain a 1,
-    // as multiplication by 1 is an identity operation.
-    std::set<ptr> l_foremost_product_operands = { ptr(new resolved(1)) };
+    // Initialize the foremost_product_operands to be empty,
+    // as the empty product is the multiplicative identity (1).
+    std::vector<ptr> l_foremost_product_operands;
 
     // A list of all sums over which we will have to distribute.
     std::set<ptr>                      l_sums;
@@ -72,7 +94,7 @@ operand::ptr product::expand(
         {
             case UNRESOLVED:
             {
-                l_foremost_product_operands.insert(l_operand);
+                l_foremost_product_operands.push_back(l_operand);
                 break;
             }
             case RESOLVED:
@@ -91,7 +113,7 @@ operand::ptr product::expand(
             }
             case INVERT:
             {
-                l_foremost_product_operands.insert(l_operand);
+                l_foremost_product_operands.push_back(l_operand);
                 break;
             }
             case PRODUCT:
@@ -104,7 +126,7 @@ operand::ptr product::expand(
                 std::copy(
                     l_product->m_operands.begin(),
                     l_product->m_operands.end(),
-                    std::inserter(l_foremost_product_operands, l_foremost_product_operands.begin())
+                    std::back_inserter(l_foremost_product_operands)
                 );
 
                 break;
@@ -123,54 +145,135 @@ operand::ptr product::expand(
 
     }
 
-    // Construct a foremost product,
-    ptr l_foremost_product = ptr(new product(l_foremost_product_operands));
-    l_foremost_product = l_foremost_product->reduce();
+    if (l_foremost_product_operands.empty() && l_sums.empty())
+        // Every operand was a 1, so the product is 1.
+        return ptr(new resolved(1));
+
+    // Construct a foremost product. Its operands are all literals,
+    // so it is already in its reduced form and must not be reduced
+    // again (doing so would just expand it right back into a product).
+    // Duplicate literals are dropped as its operands are sorted.
+    ptr l_foremost_product = ptr(new product(std::move(l_foremost_product_operands)));
 
-    // wrap it in a sum, and then
-    // add it to the front of "sums."
+    cover l_foremost_cover(std::vector<ptr>{ l_foremost_product });
+
+    if (l_foremost_cover.m_cubes[0].conflicts(l_foremost_cover.m_cubes[0]))
+        // A variable in both polarities makes the whole product 0.
+        return ptr(new resolved(0));
+
+    if (l_sums.empty())
+    {
+        // Nothing to distribute over, so prune the product as sum::expand() would.
+        l_foremost_cover.prune();
+
+        return l_foremost_cover.to_operand();
+    }
+
+    // Wrap it in a sum, so that it distributes like the others.
     l_sums.insert(ptr(new sum({l_foremost_product})));
 
-    while (l_sums.size() > 1)
-    {   
-        // Pop the first sum off of the set.
-        ptr l_first_ptr = *l_sums.begin();
-        l_sums.erase(l_sums.begin());
+    const auto l_term_count = [](
+        const ptr& a_sum
+    )
+    {
+        return ((const sum&)*a_sum).m_operands.size();
+    };
+
+    // Always distribute the two smallest sums, so that the intermediate
+    // results stay as small as they can, and are pruned (by reducing them)
+    // before the larger sums are multiplied in.
+    const auto l_is_larger = [&l_term_count](
+        const ptr& a_sum_0,
+        const ptr& a_sum_1
+    )
+    {
+        if (l_term_count(a_sum_0) != l_term_count(a_sum_1))
+            return l_term_count(a_sum_0) > l_term_count(a_sum_1);
 
-        // Pop the second sum off of the set.
-        ptr l_second_ptr = *l_sums.begin();
-        l_sums.erase(l_sums.begin());
-        
-        // Now, attempt to distribute this single
-        // foremost sum (without cloning it) over multiplication
-        // to the second sum.
-        l_sums.insert(distribute((const sum&)*l_first_ptr, (const sum&)*l_second_ptr)->reduce());
+        // Break ties structurally, so that the order is deterministic.
+        return a_sum_1 < a_sum_0;
+    };
+
+    std::priority_queue<ptr, std::vector<ptr>, decltype(l_is_larger)> l_queue(
+        l_is_larger,
+        std::vector<ptr>(l_sums.begin(), l_sums.end())
+    );
+
+    // An upper bound on the number of products in the result, before any pruning.
+    // Only once this exceeds the budget do the individual steps need checking.
+    std::size_t l_estimate = 1;
+
+    for (const ptr& l_sum : l_sums)
+        l_estimate = saturating_multiply(l_estimate, l_term_count(l_sum));
+
+    const std::size_t l_budget = distribution_budget();
+    const bool l_is_bounded = l_budget != 0 && l_estimate > l_budget;
+
+    while (l_queue.size() > 1)
+    {
+        ptr l_first_ptr = l_queue.top();
+        l_queue.pop();
+
+        ptr l_second_ptr = l_queue.top();
+        l_queue.pop();
+
+        std::size_t l_step_estimate = saturating_multiply(l_term_count(l_first_ptr), l_term_count(l_second_ptr));
+
+        if (l_is_bounded && l_step_estimate > l_budget)
+            throw distribution_budget_exceeded(l_step_estimate, l_budget);
+
+        ptr l_distributed = distribute((const sum&)*l_first_ptr, (const sum&)*l_second_ptr)->reduce();
+
+        if (l_distributed->m_operand_type != RESOLVED)
+        {
+            l_queue.push(l_distributed);
+            continue;
+        }
+
+        if (((const resolved&)*l_distributed).m_value == 0)
+            // Every distributed product was contradictory. 0 in a product reduces to zero.
+            return l_distributed;
+
+        // The distributed sum was 1, which is the multiplicative identity.
+        if (l_queue.empty())
+            return l_distributed;
 
     }
 
-    return *l_sums.begin();
+    return l_queue.top();
 
 }
 
 operand::ptr product::substitute(
-    const std::string& a_identifier,
-    const ptr& a_substitution_operand
+    const substitutions& a_substitutions
 ) const
 {
-    std::set<ptr> l_result_operands;
+    if (!depends_on(a_substitutions))
+        // None of the bound variables appear beneath this operand.
+        return self();
+
+    std::vector<ptr> l_result_operands;
+
+    bool l_is_changed = false;
     
     // Transform each operand according to the substitution rule.
     std::transform(
         m_operands.begin(),
         m_operands.end(),
-        std::inserter(l_result_operands, l_result_operands.begin()),
-        [&a_identifier, &a_substitution_operand](const ptr& a_operand)
+        std::back_inserter(l_result_operands),
+        [&a_substitutions, &l_is_changed](const ptr& a_operand)
         {
-            return a_operand->substitute(a_identifier, a_substitution_operand);
+            ptr l_result = a_operand->substitute(a_substitutions);
+            l_is_changed |= l_result.get() != a_operand.get();
+            return l_result;
         }
     );
 
-    return ptr(new product(l_result_operands));
+    if (!l_is_changed)
+        // Nothing was bound beneath this operand, so avoid rebuilding it.
+        return self();
+
+    return ptr(new product(std::move(l_result_operands)));
     
 }
 
@@ -217,32 +320,68 @@ bool product::operator<(
         // If the local has more operands, consider it to be the larger of the two.
         return false;
 
-    std::set<ptr>::iterator l_it_0 = m_operands.begin();
-    std::set<ptr>::iterator l_it_1 = l_product.m_operands.begin();
+    if (m_size != l_product.m_size)
+        // Equal operands have equal node counts, so this orders
+        // most unequal operands without descending into them.
+        return m_size < l_product.m_size;
 
-    for (int i = 0; i < m_operands.size(); i++)
+    for (std::size_t i = 0; i < m_operands.size(); i++)
     {
         // Compare element-wise.
-        if (*l_it_0 < *l_it_1)
+        if (m_operands[i] < l_product.m_operands[i])
             return true;
-        if (*l_it_0 > *l_it_1)
+        if (l_product.m_operands[i] < m_operands[i])
             return false;
-            
-        std::advance(l_it_0, 1);
-        std::advance(l_it_1, 1);
-
     }
 
     return false;
 
 }
 
+bool product::shallow_equals(
+    const operand& a_operand
+) const
+{
+    if (a_operand.m_operand_type != m_operand_type)
+        return false;
+
+    const product& l_product = (const product&)a_operand;
+
+    if (m_operands.size() != l_product.m_operands.size())
+        return false;
+
+    // The children of both operands are canonical, so compare them by address.
+    return std::equal(
+        m_operands.begin(),
+        m_operands.end(),
+        l_product.m_operands.begin(),
+        [](
+            const ptr& a_operand_0,
+            const ptr& a_operand_1
+        )
+        {
+            return a_operand_0.get() == a_operand_1.get();
+        }
+    );
+
+}
+
 operand::ptr product::distribute(
     const sum& a_sum_0,
     const sum& a_sum_1
 )
 {
-    std::set<ptr> l_result_operands;
+    std::size_t l_thread_count = distribution_thread_count();
+
+    if (l_thread_count == 0)
+        l_thread_count = scheduler::thread_count();
+
+    if (l_thread_count > 1 && a_sum_0.m_operands.size() * a_sum_1.m_operands.size() >= PARALLEL_DISTRIBUTION_THRESHOLD)
+        return distribute(a_sum_0, a_sum_1, l_thread_count);
+
+    std::vector<ptr> l_result_operands;
+
+    l_result_operands.reserve(a_sum_0.m_operands.size() * a_sum_1.m_operands.size());
 
     for (const ptr& l_operand_0 : a_sum_0.m_operands)
     {
@@ -253,15 +392,142 @@ operand::ptr product::distribute(
         {
             // Sanity check on second operand's child
             assert(l_operand_1->m_operand_type == PRODUCT);
-            
-            ptr l_product = ptr(new product({l_operand_0, l_operand_1}));
 
-            l_result_operands.insert(l_product);
+            const product& l_product_0 = (const product&)*l_operand_0;
+            const product& l_product_1 = (const product&)*l_operand_1;
+
+            // Merge the literals of both products, rather than nesting
+            // the products, so the result stays flat. Both are sorted,
+            // so a single pass over each suffices.
+            std::vector<ptr> l_literals;
+
+            l_literals.reserve(l_product_0.m_operands.size() + l_product_1.m_operands.size());
+
+            std::set_union(
+                l_product_0.m_operands.begin(),
+                l_product_0.m_operands.end(),
+                l_product_1.m_operands.begin(),
+                l_product_1.m_operands.end(),
+                std::back_inserter(l_literals)
+            );
+            
+            l_result_operands.push_back(ptr(new product(std::move(l_literals))));
             
         }
         
     }
 
-    return ptr(new sum(l_result_operands));
+    return ptr(new sum(std::move(l_result_operands)));
+    
+}
+
+operand::ptr product::distribute(
+    const sum& a_sum_0,
+    const sum& a_sum_1,
+    const std::size_t& a_thread_count
+)
+{
+    // Pack both sums into cubes over a common index of variables up front, so
+    // that the workers never contend for the unique table while they multiply.
+    std::vector<ptr> l_products(a_sum_0.m_operands.begin(), a_sum_0.m_operands.end());
+    l_products.insert(l_products.end(), a_sum_1.m_operands.begin(), a_sum_1.m_operands.end());
+
+    cover l_cover(l_products);
+
+    const std::size_t l_split = a_sum_0.m_operands.size();
+    const std::size_t l_words = l_cover.make_cube().m_positive.size();
+
+    // Each job claims products of the first sum until none remain, and
+    // multiplies them by every product of the second sum.
+    std::atomic<std::size_t> l_next_row(0);
+
+    const std::size_t l_job_count = std::min(a_thread_count, l_split);
+
+    std::vector<std::unordered_set<cube, cube::hasher>> l_local(l_job_count);
+
+    auto l_worker = [&](
+        const std::size_t& a_job
+    )
+    {
+        for (std::size_t l_row = l_next_row++; l_row < l_split; l_row = l_next_row++)
+        {
+            const cube& l_cube_0 = l_cover.m_cubes[l_row];
+
+            for (std::size_t j = l_split; j < l_cover.m_cubes.size(); j++)
+            {
+                const cube& l_cube_1 = l_cover.m_cubes[j];
+
+                if (l_cube_0.conflicts(l_cube_1))
+                    // The product holds a variable in both polarities, so it is 0.
+                    continue;
+
+                cube l_cube = l_cube_0;
+
+                for (std::size_t i = 0; i < l_words; i++)
+                {
+                    l_cube.m_positive[i] |= l_cube_1.m_positive[i];
+                    l_cube.m_negative[i] |= l_cube_1.m_negative[i];
+                }
+
+                l_local[a_job].insert(l_cube);
+                
+            }
+        }
+    };
+
+    // The jobs run on the scheduler's pool, so that nested distributions and
+    // parallel reductions share its threads rather than oversubscribe.
+    std::vector<std::function<void()>> l_jobs;
+
+    for (std::size_t i = 0; i < l_job_count; i++)
+        l_jobs.push_back([&l_worker, i]() { l_worker(i); });
+
+    scheduler::run(l_jobs);
+
+    // Merge the per-job results, dropping the products found by more than one job.
+    std::unordered_set<cube, cube::hasher> l_merged;
+
+    for (std::unordered_set<cube, cube::hasher>& l_cubes : l_local)
+        l_merged.merge(l_cubes);
+
+    l_cover.m_cubes.assign(l_merged.begin(), l_merged.end());
+
+    return l_cover.to_operand();
     
 }
+
+std::size_t product::distribution_budget(
+
+)
+{
+    return configuration().m_budget;
+}
+
+void product::set_distribution_budget(
+    const std::size_t& a_budget
+)
+{
+    configuration().m_budget = a_budget;
+}
+
+std::size_t product::distribution_thread_count(
+
+)
+{
+    return configuration().m_thread_count;
+}
+
+void product::set_distribution_thread_count(
+    const std::size_t& a_thread_count
+)
+{
+    configuration().m_thread_count = a_thread_count;
+}
+
+product::settings& product::configuration(
+
+)
+{
+    static settings l_settings;
+    return l_settings;
+}
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/calculator.hpp"
+
+using namespace ba_calculator;
+
+operand::ptr reduce_cache::find(
+    const operand::ptr& a_operand
+)
+{
+    entries_type& l_entries = entries();
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    auto l_it = l_entries.m_index.find(a_operand.get());
+
+    if (l_it == l_entries.m_index.end())
+    {
+        l_entries.m_misses++;
+        return operand::ptr(nullptr);
+    }
+
+    l_entries.m_hits++;
+
+    // Mark the entry as the most recently used.
+    l_entries.m_recency.splice(l_entries.m_recency.begin(), l_entries.m_recency, l_it->second);
+
+    return l_it->second->m_result;
+    
+}
+
+void reduce_cache::insert(
+    const operand::ptr& a_operand,
+    const operand::ptr& a_result
+)
+{
+    entries_type& l_entries = entries();
+
+    std::list<entry> l_evicted;
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    if (l_entries.m_capacity == 0)
+        return;
+
+    if (l_entries.m_index.count(a_operand.get()) > 0)
+        // Another thread may have reduced the same operand in the meantime.
+        return;
+
+    l_entries.m_recency.push_front({a_operand, a_result, arena::current()});
+    l_entries.m_index.insert({a_operand.get(), l_entries.m_recency.begin()});
+
+    l_evicted = evict();
+    
+}
+
+void reduce_cache::clear(
+
+)
+{
+    entries_type& l_entries = entries();
+
+    std::list<entry> l_evicted;
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    l_entries.m_index.clear();
+    l_entries.m_recency.swap(l_evicted);
+    l_entries.m_hits = 0;
+    l_entries.m_misses = 0;
+    
+}
+
+std::size_t reduce_cache::size(
+
+)
+{
+    entries_type& l_entries = entries();
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    return l_entries.m_index.size();
+    
+}
+
+std::size_t reduce_cache::hits(
+
+)
+{
+    entries_type& l_entries = entries();
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    return l_entries.m_hits;
+    
+}
+
+std::size_t reduce_cache::misses(
+
+)
+{
+    entries_type& l_entries = entries();
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    return l_entries.m_misses;
+    
+}
+
+std::size_t reduce_cache::capacity(
+
+)
+{
+    entries_type& l_entries = entries();
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    return l_entries.m_capacity;
+    
+}
+
+void reduce_cache::set_capacity(
+    const std::size_t& a_capacity
+)
+{
+    entries_type& l_entries = entries();
+
+    std::list<entry> l_evicted;
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    l_entries.m_capacity = a_capacity;
+
+    l_evicted = evict();
+    
+}
+
+void reduce_cache::release(
+    const arena* a_arena
+)
+{
+    entries_type& l_entries = entries();
+
+    std::list<entry> l_released;
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    for (auto l_it = l_entries.m_recency.begin(); l_it != l_entries.m_recency.end();)
+    {
+        auto l_next = std::next(l_it);
+
+        if (l_it->m_arena == a_arena)
+        {
+            // As with evict(), the operands are destroyed once the lock is released.
+            l_entries.m_index.erase(l_it->m_operand.get());
+            l_released.splice(l_released.end(), l_entries.m_recency, l_it);
+        }
+
+        l_it = l_next;
+    }
+    
+}
+
+std::size_t reduce_cache::hasher::operator()(
+    const operand* a_operand
+) const
+{
+    return a_operand->m_hash;
+}
+
+bool reduce_cache::equality::operator()(
+    const operand* a_operand_0,
+    const operand* a_operand_1
+) const
+{
+    return *a_operand_0 == *a_operand_1;
+}
+
+reduce_cache::entries_type& reduce_cache::entries(
+
+)
+{
+    // Intentionally never destroyed, see unique_table::entries().
+    static entries_type* l_entries = new entries_type();
+    return *l_entries;
+}
+
+std::list<reduce_cache::entry> reduce_cache::evict(
+
+)
+{
+    entries_type& l_entries = entries();
+
+    std::list<entry> l_evicted;
+
+    while (l_entries.m_index.size() > l_entries.m_capacity)
+    {
+        // Drop the least recently used entry. Its operands are handed back to the
+        // caller, so that they are only destroyed once the lock is released.
+        l_entries.m_index.erase(l_entries.m_recency.back().m_operand.get());
+        l_evicted.splice(l_evicted.begin(), l_entries.m_recency, std::prev(l_entries.m_recency.end()));
+
+    }
+
+    return l_evicted;
+    
+}
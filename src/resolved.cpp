@@ -21,15 +21,14 @@ resolved::resolved(
     operand(RESOLVED),
     m_value(a_value)
 {
-
+    m_hash = combine_hash(m_hash, std::hash<bool>()(a_value));
 }
 
 operand::ptr resolved::substitute(
-    const std::string& a_identifier,
-    const ptr& a_operand
+    const substitutions&
 ) const
 {
-    return ptr((operand*)this);
+    return self();
 }
 
 std::string resolved::to_string(
@@ -53,3 +52,16 @@ bool resolved::operator<(
     return !m_value && l_resolved.m_value;
     
 }
+
+bool resolved::shallow_equals(
+    const operand& a_operand
+) const
+{
+    if (a_operand.m_operand_type != m_operand_type)
+        return false;
+
+    const resolved& l_resolved = (const resolved&)a_operand;
+
+    return m_value == l_resolved.m_value;
+    
+}
@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/calculator.hpp"
+
+using namespace ba_calculator;
+
+namespace
+{
+    const std::size_t NOT_A_WORKER = std::size_t(-1);
+
+    thread_local std::size_t s_worker_index = NOT_A_WORKER;
+    thread_local bool        s_is_parallel = false;
+
+}
+
+void scheduler::run(
+    const std::vector<std::function<void()>>& a_jobs
+)
+{
+    if (a_jobs.empty())
+        return;
+
+    entries_type& l_entries = entries();
+
+    {
+        std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+        if (!l_entries.m_is_started)
+            start(l_entries, 0);
+    }
+
+    group l_group;
+    l_group.m_pending = a_jobs.size() - 1;
+
+    // Outside threads share the last deque.
+    worker_deque& l_deque = s_worker_index != NOT_A_WORKER ?
+        l_entries.m_deques[s_worker_index] :
+        l_entries.m_deques.back();
+
+    if (a_jobs.size() > 1)
+    {
+        {
+            std::lock_guard<std::mutex> l_lock(l_deque.m_mutex);
+
+            for (std::size_t i = 1; i < a_jobs.size(); i++)
+                l_deque.m_jobs.push_back({ &a_jobs[i], &l_group, arena::current() });
+        }
+
+        l_entries.m_queued += a_jobs.size() - 1;
+
+        {
+            // Synchronize with the workers checking for jobs before they sleep,
+            // so that none of them misses the notification.
+            std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+        }
+
+        l_entries.m_condition.notify_all();
+    }
+
+    // Run the first job here, outside of the group's count.
+    group l_inline_group;
+    l_inline_group.m_pending = 1;
+
+    execute({ &a_jobs[0], &l_inline_group, arena::current() });
+
+    // Rather than block, help out until the rest of the jobs are done. This is
+    // what allows jobs to fork and wait on jobs of their own.
+    while (l_group.m_pending > 0)
+        if (!run_one(l_entries))
+            std::this_thread::yield();
+
+    if (l_inline_group.m_exception)
+        std::rethrow_exception(l_inline_group.m_exception);
+
+    if (l_group.m_exception)
+        std::rethrow_exception(l_group.m_exception);
+    
+}
+
+bool scheduler::is_parallel(
+
+)
+{
+    return s_is_parallel;
+}
+
+std::size_t scheduler::thread_count(
+
+)
+{
+    entries_type& l_entries = entries();
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    if (!l_entries.m_is_started)
+        start(l_entries, 0);
+
+    return l_entries.m_thread_count;
+    
+}
+
+void scheduler::set_thread_count(
+    const std::size_t& a_thread_count
+)
+{
+    entries_type& l_entries = entries();
+
+    stop(l_entries);
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    start(l_entries, a_thread_count);
+    
+}
+
+scheduler::scope::~scope(
+
+)
+{
+    s_is_parallel = m_previous;
+}
+
+scheduler::scope::scope(
+
+) :
+    m_previous(s_is_parallel)
+{
+    s_is_parallel = true;
+}
+
+scheduler::entries_type& scheduler::entries(
+
+)
+{
+    // Intentionally never destroyed, so that the workers
+    // need not be joined during static destruction.
+    static entries_type* l_entries = new entries_type();
+    return *l_entries;
+}
+
+void scheduler::start(
+    entries_type& a_entries,
+    const std::size_t& a_thread_count
+)
+{
+    a_entries.m_thread_count = a_thread_count != 0 ?
+        a_thread_count :
+        std::max<std::size_t>(1, std::thread::hardware_concurrency());
+
+    // The calling thread of run() does its share of the work too,
+    // so one fewer worker is needed than there are threads.
+    std::size_t l_worker_count = a_entries.m_thread_count - 1;
+
+    for (std::size_t i = 0; i < l_worker_count + 1; i++)
+        a_entries.m_deques.emplace_back();
+
+    for (std::size_t i = 0; i < l_worker_count; i++)
+    {
+        a_entries.m_threads.emplace_back(
+            [&a_entries, i]()
+            {
+                s_worker_index = i;
+                s_is_parallel = true;
+
+                while (true)
+                {
+                    if (run_one(a_entries))
+                        continue;
+
+                    std::unique_lock<std::mutex> l_lock(a_entries.m_mutex);
+
+                    a_entries.m_condition.wait(
+                        l_lock,
+                        [&a_entries]()
+                        {
+                            return a_entries.m_is_stopping || a_entries.m_queued > 0;
+                        }
+                    );
+
+                    if (a_entries.m_is_stopping)
+                        return;
+                    
+                }
+            }
+        );
+    }
+
+    a_entries.m_is_started = true;
+    
+}
+
+void scheduler::stop(
+    entries_type& a_entries
+)
+{
+    {
+        std::lock_guard<std::mutex> l_lock(a_entries.m_mutex);
+
+        if (!a_entries.m_is_started)
+            return;
+
+        a_entries.m_is_stopping = true;
+    }
+
+    a_entries.m_condition.notify_all();
+
+    for (std::thread& l_thread : a_entries.m_threads)
+        l_thread.join();
+
+    std::lock_guard<std::mutex> l_lock(a_entries.m_mutex);
+
+    a_entries.m_threads.clear();
+    a_entries.m_deques.clear();
+    a_entries.m_is_stopping = false;
+    a_entries.m_is_started = false;
+    
+}
+
+bool scheduler::run_one(
+    entries_type& a_entries
+)
+{
+    if (a_entries.m_queued == 0)
+        return false;
+
+    std::size_t l_deque_count = a_entries.m_deques.size();
+
+    std::size_t l_own = s_worker_index != NOT_A_WORKER ? s_worker_index : l_deque_count - 1;
+
+    job l_job = { nullptr, nullptr, nullptr };
+
+    // Take the most recently forked job of our own, or else
+    // steal the oldest job of the next thread which has any.
+    for (std::size_t i = 0; i < l_deque_count && l_job.m_work == nullptr; i++)
+    {
+        worker_deque& l_deque = a_entries.m_deques[(l_own + i) % l_deque_count];
+
+        std::lock_guard<std::mutex> l_lock(l_deque.m_mutex);
+
+        if (l_deque.m_jobs.empty())
+            continue;
+
+        if (i == 0)
+        {
+            l_job = l_deque.m_jobs.back();
+            l_deque.m_jobs.pop_back();
+        }
+        else
+        {
+            l_job = l_deque.m_jobs.front();
+            l_deque.m_jobs.pop_front();
+        }
+        
+    }
+
+    if (l_job.m_work == nullptr)
+        return false;
+
+    a_entries.m_queued--;
+
+    execute(l_job);
+
+    return true;
+    
+}
+
+void scheduler::execute(
+    const job& a_job
+)
+{
+    try
+    {
+        // Stolen jobs allocate where their forking thread would have.
+        arena::adoption l_adoption(a_job.m_arena);
+
+        (*a_job.m_work)();
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> l_lock(a_job.m_group->m_mutex);
+
+        if (!a_job.m_group->m_exception)
+            a_job.m_group->m_exception = std::current_exception();
+    }
+
+    // The group may be destroyed as soon as its count reaches zero,
+    // so this must be the last access to it.
+    a_job.m_group->m_pending--;
+    
+}
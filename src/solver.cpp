@@ -0,0 +1,490 @@
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/solver.hpp"
+
+using namespace ba_calculator;
+
+solver::solver(
+    const cnf& a_cnf
+) :
+    m_watches(2 * a_cnf.m_variable_count),
+    m_variables(a_cnf.m_variable_count, variable_state{ -1, false, false, 0, NO_CLAUSE, 0 }),
+    m_propagated(0),
+    m_increment(1),
+    m_is_inconsistent(false),
+    m_conflicts(0)
+{
+    for (std::size_t i = 0; i < m_variables.size(); i++)
+        m_order.push({ 0, i });
+
+    for (const cnf::clause& l_clause : a_cnf.m_clauses)
+        add_clause(l_clause);
+
+}
+
+void solver::add_clause(
+    const cnf::clause& a_clause
+)
+{
+    if (m_is_inconsistent)
+        return;
+
+    backtrack(0);
+
+    std::vector<code> l_clause;
+
+    for (const literal& l_literal : a_clause)
+    {
+        assert(l_literal != 0 && std::size_t(std::abs(l_literal)) <= m_variables.size());
+        l_clause.push_back(encode(l_literal));
+    }
+
+    std::sort(l_clause.begin(), l_clause.end());
+    l_clause.erase(std::unique(l_clause.begin(), l_clause.end()), l_clause.end());
+
+    for (std::size_t i = 0; i + 1 < l_clause.size(); i++)
+        if ((l_clause[i] ^ 1) == l_clause[i + 1])
+            // Holding a literal in both polarities, the clause is always satisfied.
+            return;
+
+    if (std::any_of(l_clause.begin(), l_clause.end(), [this](const code& a_code) { return value(a_code) == 1; }))
+        // Already satisfied at the root.
+        return;
+
+    // Literals which are false at the root can never satisfy the clause.
+    l_clause.erase(
+        std::remove_if(
+            l_clause.begin(),
+            l_clause.end(),
+            [this](
+                const code& a_code
+            )
+            {
+                return value(a_code) == 0;
+            }
+        ),
+        l_clause.end()
+    );
+
+    if (l_clause.empty())
+    {
+        m_is_inconsistent = true;
+        return;
+    }
+
+    if (l_clause.size() == 1)
+    {
+        assign(l_clause[0], NO_CLAUSE);
+
+        if (propagate() != NO_CLAUSE)
+            m_is_inconsistent = true;
+
+        return;
+    }
+
+    attach(std::move(l_clause));
+
+}
+
+bool solver::solve(
+
+)
+{
+    if (m_is_inconsistent)
+        return false;
+
+    backtrack(0);
+
+    std::size_t l_restarts = 0;
+    std::size_t l_conflicts = 0;
+
+    while (true)
+    {
+        std::size_t l_conflict = propagate();
+
+        if (l_conflict != NO_CLAUSE)
+        {
+            m_conflicts++;
+            l_conflicts++;
+
+            if (m_trail_limits.empty())
+            {
+                // A conflict without any decision is a refutation.
+                m_is_inconsistent = true;
+                return false;
+            }
+
+            std::vector<code> l_learnt = analyze(l_conflict);
+
+            backtrack(l_learnt.size() == 1 ? 0 : m_variables[l_learnt[1] >> 1].m_level);
+
+            if (l_learnt.size() == 1)
+                assign(l_learnt[0], NO_CLAUSE);
+            else
+            {
+                code l_asserting = l_learnt[0];
+                attach(std::move(l_learnt));
+                assign(l_asserting, m_clauses.size() - 1);
+            }
+
+            // Favor the variables of recent conflicts over older ones.
+            m_increment /= 0.95;
+
+            continue;
+        }
+
+        if (l_conflicts >= RESTART_INTERVAL * luby(l_restarts))
+        {
+            l_restarts++;
+            l_conflicts = 0;
+            backtrack(0);
+            continue;
+        }
+
+        if (!decide())
+            break;
+    }
+
+    m_model.assign(m_variables.size(), false);
+
+    for (std::size_t i = 0; i < m_variables.size(); i++)
+        m_model[i] = m_variables[i].m_value == 1;
+
+    return true;
+
+}
+
+bool solver::value(
+    const literal& a_variable
+) const
+{
+    assert(a_variable > 0 && std::size_t(a_variable) <= m_model.size());
+    return m_model[a_variable - 1];
+}
+
+std::size_t solver::variable_count(
+
+) const
+{
+    return m_variables.size();
+}
+
+std::size_t solver::conflict_count(
+
+) const
+{
+    return m_conflicts;
+}
+
+bool solver::is_satisfiable(
+    const operand::ptr& a_operand
+)
+{
+    solver l_solver(cnf::tseitin(a_operand));
+    return l_solver.solve();
+}
+
+bool solver::is_tautology(
+    const operand::ptr& a_operand
+)
+{
+    return !is_satisfiable(operand::ptr(new invert(a_operand)));
+}
+
+bool solver::equivalent(
+    const operand::ptr& a_operand_0,
+    const operand::ptr& a_operand_1
+)
+{
+    if (a_operand_0.get() == a_operand_1.get())
+        return true;
+
+    // The operands differ exactly where their exclusive or holds. Their
+    // common subterms are interned, and so are encoded only once.
+    return !is_satisfiable(operand::ptr(new sum({
+        operand::ptr(new product({a_operand_0, operand::ptr(new invert(a_operand_1))})),
+        operand::ptr(new product({operand::ptr(new invert(a_operand_0)), a_operand_1}))
+    })));
+
+}
+
+solver::code solver::encode(
+    const literal& a_literal
+)
+{
+    return code(std::abs(a_literal) - 1) * 2 + (a_literal < 0);
+}
+
+int solver::value(
+    const code& a_code
+) const
+{
+    std::int8_t l_value = m_variables[a_code >> 1].m_value;
+
+    if (l_value < 0)
+        return -1;
+
+    return l_value ^ (a_code & 1);
+
+}
+
+void solver::assign(
+    const code& a_code,
+    const std::size_t& a_reason
+)
+{
+    variable_state& l_variable = m_variables[a_code >> 1];
+
+    l_variable.m_value = !(a_code & 1);
+    l_variable.m_level = m_trail_limits.size();
+    l_variable.m_reason = a_reason;
+
+    m_trail.push_back(a_code);
+
+}
+
+void solver::attach(
+    std::vector<code> a_clause
+)
+{
+    m_watches[a_clause[0]].push_back(m_clauses.size());
+    m_watches[a_clause[1]].push_back(m_clauses.size());
+
+    m_clauses.push_back(std::move(a_clause));
+
+}
+
+std::size_t solver::propagate(
+
+)
+{
+    while (m_propagated < m_trail.size())
+    {
+        code l_false = m_trail[m_propagated++] ^ 1;
+
+        std::vector<std::size_t>& l_watches = m_watches[l_false];
+
+        std::size_t j = 0;
+
+        for (std::size_t i = 0; i < l_watches.size(); i++)
+        {
+            std::vector<code>& l_clause = m_clauses[l_watches[i]];
+
+            // Keep the false literal second, so that the first is the one implied.
+            if (l_clause[0] == l_false)
+                std::swap(l_clause[0], l_clause[1]);
+
+            if (value(l_clause[0]) == 1)
+            {
+                l_watches[j++] = l_watches[i];
+                continue;
+            }
+
+            // Look for another literal to watch, which is not false.
+            std::size_t k = 2;
+
+            while (k < l_clause.size() && value(l_clause[k]) == 0)
+                k++;
+
+            if (k < l_clause.size())
+            {
+                std::swap(l_clause[1], l_clause[k]);
+                m_watches[l_clause[1]].push_back(l_watches[i]);
+                continue;
+            }
+
+            l_watches[j++] = l_watches[i];
+
+            if (value(l_clause[0]) == 0)
+            {
+                std::size_t l_conflict = l_watches[i];
+
+                // Keep the remaining watches, which were never visited.
+                for (i++; i < l_watches.size(); i++)
+                    l_watches[j++] = l_watches[i];
+
+                l_watches.resize(j);
+
+                return l_conflict;
+            }
+
+            assign(l_clause[0], l_watches[i]);
+
+        }
+
+        l_watches.resize(j);
+
+    }
+
+    return NO_CLAUSE;
+
+}
+
+std::vector<solver::code> solver::analyze(
+    const std::size_t& a_conflict
+)
+{
+    // The first literal is filled in once the implication point is found.
+    std::vector<code> l_learnt(1);
+
+    std::size_t l_level = m_trail_limits.size();
+    std::size_t l_pending = 0;
+    std::size_t l_index = m_trail.size();
+    std::size_t l_clause = a_conflict;
+
+    code l_implied = 0;
+    bool l_is_first = true;
+
+    do
+    {
+        const std::vector<code>& l_literals = m_clauses[l_clause];
+
+        // The first literal of a reason clause is the one it implied.
+        for (std::size_t i = l_is_first ? 0 : 1; i < l_literals.size(); i++)
+        {
+            variable_state& l_variable = m_variables[l_literals[i] >> 1];
+
+            if (l_variable.m_is_seen || l_variable.m_level == 0)
+                continue;
+
+            l_variable.m_is_seen = true;
+            bump(l_literals[i] >> 1);
+
+            if (l_variable.m_level == l_level)
+                l_pending++;
+            else
+                l_learnt.push_back(l_literals[i]);
+        }
+
+        // Walk back along the trail to the next literal involved in the conflict.
+        while (!m_variables[m_trail[--l_index] >> 1].m_is_seen);
+
+        l_implied = m_trail[l_index];
+        l_clause = m_variables[l_implied >> 1].m_reason;
+        m_variables[l_implied >> 1].m_is_seen = false;
+        l_pending--;
+        l_is_first = false;
+
+    }
+    while (l_pending > 0);
+
+    l_learnt[0] = l_implied ^ 1;
+
+    for (std::size_t i = 1; i < l_learnt.size(); i++)
+        m_variables[l_learnt[i] >> 1].m_is_seen = false;
+
+    // Watch a literal of the backjump level second, which is the last to be unassigned.
+    for (std::size_t i = 2; i < l_learnt.size(); i++)
+        if (m_variables[l_learnt[i] >> 1].m_level > m_variables[l_learnt[1] >> 1].m_level)
+            std::swap(l_learnt[1], l_learnt[i]);
+
+    return l_learnt;
+
+}
+
+void solver::backtrack(
+    const std::size_t& a_level
+)
+{
+    if (m_trail_limits.size() <= a_level)
+        return;
+
+    for (std::size_t i = m_trail_limits[a_level]; i < m_trail.size(); i++)
+    {
+        variable_state& l_variable = m_variables[m_trail[i] >> 1];
+
+        // Save the phase, so that the search returns to where it left off.
+        l_variable.m_phase = l_variable.m_value == 1;
+        l_variable.m_value = -1;
+        l_variable.m_reason = NO_CLAUSE;
+
+        m_order.push({ l_variable.m_activity, m_trail[i] >> 1 });
+    }
+
+    m_trail.resize(m_trail_limits[a_level]);
+    m_trail_limits.resize(a_level);
+    m_propagated = m_trail.size();
+
+}
+
+void solver::bump(
+    const std::size_t& a_variable
+)
+{
+    m_variables[a_variable].m_activity += m_increment;
+
+    if (m_variables[a_variable].m_activity > 1e100)
+    {
+        // Rescale before the activities overflow, keeping their order.
+        for (variable_state& l_variable : m_variables)
+            l_variable.m_activity *= 1e-100;
+
+        m_increment *= 1e-100;
+
+        m_order = std::priority_queue<std::pair<double, std::size_t>>();
+
+        for (std::size_t i = 0; i < m_variables.size(); i++)
+            if (m_variables[i].m_value < 0)
+                m_order.push({ m_variables[i].m_activity, i });
+
+        return;
+    }
+
+    m_order.push({ m_variables[a_variable].m_activity, a_variable });
+
+}
+
+bool solver::decide(
+
+)
+{
+    while (!m_order.empty())
+    {
+        auto [l_activity, l_index] = m_order.top();
+        m_order.pop();
+
+        const variable_state& l_variable = m_variables[l_index];
+
+        if (l_variable.m_value >= 0 || l_activity != l_variable.m_activity)
+            // Assigned, or left behind by a bump.
+            continue;
+
+        m_trail_limits.push_back(m_trail.size());
+        assign(code(l_index) * 2 + !l_variable.m_phase, NO_CLAUSE);
+
+        return true;
+    }
+
+    return false;
+
+}
+
+std::size_t solver::luby(
+    std::size_t a_index
+)
+{
+    // Find the finite subsequence holding the index, and the index within it.
+    std::size_t l_size = 1;
+    std::size_t l_exponent = 0;
+
+    while (l_size < a_index + 1)
+    {
+        l_exponent++;
+        l_size = 2 * l_size + 1;
+    }
+
+    while (l_size - 1 != a_index)
+    {
+        l_size = (l_size - 1) >> 1;
+        l_exponent--;
+        a_index = a_index % l_size;
+    }
+
+    return std::size_t(1) << l_exponent;
+
+}
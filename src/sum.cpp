@@ -3,6 +3,8 @@
 #include <iterator>
 #include <sstream>
 #include <assert.h>
+#include <bit>
+#include <unordered_set>
 
 #include "include/calculator.hpp"
 
@@ -16,26 +18,39 @@ sum::~sum(
 }
 
 sum::sum(
-    const std::set<ptr>& a_operands
+    operand_list a_operands
 ) :
     operand(SUM),
-    m_operands(a_operands)
+    m_operands(std::move(a_operands))
 {
-    
+    for (const ptr& l_operand : m_operands)
+    {
+        m_hash = combine_hash(m_hash, l_operand->m_hash);
+        m_size += l_operand->m_size;
+        m_depth = std::max(m_depth, l_operand->m_depth + 1);
+        merge_support(*l_operand);
+    }
 }
 
-operand::ptr sum::simplify(
+operand::ptr sum::reduce_operands(
 
 ) const
 {
+    return ptr(new sum(reduce_each(m_operands)));
+}
 
+operand::ptr sum::simplify(
+
+) const
+{
+    return self();
 }
 
 operand::ptr sum::expand(
 
 ) const
 {
-    std::set<ptr> l_products;
+    std::vector<ptr> l_products;
 
     for (const ptr& l_operand : m_operands)
     {
@@ -45,7 +60,7 @@ operand::ptr sum::expand(
         {
             case UNRESOLVED:
             {
-                l_products.insert(ptr(new product({l_simplified_operand})));
+                l_products.push_back(ptr(new product({l_simplified_operand})));
                 break;
             }
             case RESOLVED:
@@ -62,12 +77,12 @@ operand::ptr sum::expand(
             }
             case INVERT:
             {
-                l_products.insert(ptr(new product({l_simplified_operand})));
+                l_products.push_back(ptr(new product({l_simplified_operand})));
                 break;
             }
             case PRODUCT:
             {
-                l_products.insert(l_simplified_operand);
+                l_products.push_back(l_simplified_operand);
                 break;
             }
             case SUM:
@@ -80,7 +95,7 @@ operand::ptr sum::expand(
                 std::transform(
                     l_sum->m_operands.begin(),
                     l_sum->m_operands.end(),
-                    std::inserter(l_products, l_products.begin()),
+                    std::back_inserter(l_products),
                     [](
                         const ptr& a_child_operand
                     )
@@ -97,59 +112,54 @@ operand::ptr sum::expand(
             }
             default:
             {
-                throw std::runtime_error("Error: unknown operand type in product::simplify()");
+                throw std::runtime_error("Error: unknown operand type in sum::expand()");
             }
         }
 
-        // Now that we've aggregated a bunch of products in the sum, we need to
-        // find coverages.
-
-        for (auto l_it_0 = l_products.begin(); l_it_0 != l_products.end(); std::advance(l_it_0, 1))
-        {
-            for (auto l_it_1 = l_products.begin(); l_it_1 != l_products.end();)
-            {
+    }
 
-                // Save the current iterator as a temporary var,
-                // and advance the iterator l_it_1 to the next position,
-                // so that if we do invalidate the current iterator,
-                // we will be able to continue iteration. 
-                auto l_current = l_it_1;
-                std::advance(l_it_1, 1);
-                
-                if (l_it_0 == l_it_1)
-                    continue;
+    // Now that we've aggregated a bunch of products in the sum, we need to
+    // find coverages, and merge products which differ in a single polarity.
+    // Duplicate products cover one another, so they are dropped along with the rest.
+    cover l_cover(l_products);
 
-                if (covers((const product&)**l_it_0, (const product&)**l_current))
-                    l_products.erase(l_current);
+    l_cover.prune();
 
-            }
-        }
-
-        return ptr(new sum(l_products));
-        
-    }
+    // An empty cover is 0, and a cover holding the empty cube is 1.
+    return l_cover.to_operand();
     
 }
 
 operand::ptr sum::substitute(
-    const std::string& a_identifier,
-    const ptr& a_substitution_operand
+    const substitutions& a_substitutions
 ) const
 {
-    std::set<ptr> l_result_operands;
+    if (!depends_on(a_substitutions))
+        // None of the bound variables appear beneath this operand.
+        return self();
+
+    std::vector<ptr> l_result_operands;
+
+    bool l_is_changed = false;
     
     // Transform each operand according to the substitution rule.
     std::transform(
         m_operands.begin(),
         m_operands.end(),
-        std::inserter(l_result_operands, l_result_operands.begin()),
-        [&a_identifier, &a_substitution_operand](const ptr& a_operand)
+        std::back_inserter(l_result_operands),
+        [&a_substitutions, &l_is_changed](const ptr& a_operand)
         {
-            return a_operand->substitute(a_identifier, a_substitution_operand);
+            ptr l_result = a_operand->substitute(a_substitutions);
+            l_is_changed |= l_result.get() != a_operand.get();
+            return l_result;
         }
     );
 
-    return ptr(new sum(l_result_operands));
+    if (!l_is_changed)
+        // Nothing was bound beneath this operand, so avoid rebuilding it.
+        return self();
+
+    return ptr(new sum(std::move(l_result_operands)));
     
 }
 
@@ -196,55 +206,48 @@ bool sum::operator<(
         // If the local has more operands, consider it to be the larger of the two.
         return false;
 
-    std::set<ptr>::iterator l_it_0 = m_operands.begin();
-    std::set<ptr>::iterator l_it_1 = l_sum.m_operands.begin();
+    if (m_size != l_sum.m_size)
+        // Equal operands have equal node counts, so this orders
+        // most unequal operands without descending into them.
+        return m_size < l_sum.m_size;
 
-    for (int i = 0; i < m_operands.size(); i++)
+    for (std::size_t i = 0; i < m_operands.size(); i++)
     {
         // Compare element-wise.
-        if (*l_it_0 < *l_it_1)
+        if (m_operands[i] < l_sum.m_operands[i])
             return true;
-        if (*l_it_0 > *l_it_1)
+        if (l_sum.m_operands[i] < m_operands[i])
             return false;
-
-        std::advance(l_it_0, 1);
-        std::advance(l_it_1, 1);
-        
     }
 
     return false;
 
 }
 
-bool sum::covers(
-    const product& a_product_0,
-    const product& a_product_1
-)
+bool sum::shallow_equals(
+    const operand& a_operand
+) const
 {
-    for (const ptr& l_product_0_operand : a_product_0.m_operands)
-    {
-        // Each operand in the product will be a literal.
-        assert(l_product_0_operand->m_operand_type == INVERT || l_product_0_operand->m_operand_type == UNRESOLVED);
-           
-        if (
-            !std::binary_search(
-                a_product_1.m_operands.begin(),
-                a_product_1.m_operands.end(),
-                l_product_0_operand
-            )
-        )
-            return false;
+    if (a_operand.m_operand_type != m_operand_type)
+        return false;
 
-    }
+    const sum& l_sum = (const sum&)a_operand;
 
-    return true;
-    
-}
+    if (m_operands.size() != l_sum.m_operands.size())
+        return false;
 
-bool sum::are_opposites(
-    const product& a_product_0,
-    const product& a_product_1
-)
-{
+    // The children of both operands are canonical, so compare them by address.
+    return std::equal(
+        m_operands.begin(),
+        m_operands.end(),
+        l_sum.m_operands.begin(),
+        [](
+            const ptr& a_operand_0,
+            const ptr& a_operand_1
+        )
+        {
+            return a_operand_0.get() == a_operand_1.get();
+        }
+    );
 
 }
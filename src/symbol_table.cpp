@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/calculator.hpp"
+
+using namespace ba_calculator;
+
+std::size_t symbol_table::intern(
+    const std::string& a_identifier
+)
+{
+    entries_type& l_entries = entries();
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    auto l_inserted = l_entries.m_variables.insert({a_identifier, l_entries.m_identifiers.size()});
+
+    if (l_inserted.second)
+        // This is the first time we've seen the identifier, record its name.
+        l_entries.m_identifiers.push_back(a_identifier);
+
+    return l_inserted.first->second;
+    
+}
+
+std::size_t symbol_table::find(
+    const std::string& a_identifier
+)
+{
+    entries_type& l_entries = entries();
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    auto l_it = l_entries.m_variables.find(a_identifier);
+
+    if (l_it == l_entries.m_variables.end())
+        return npos;
+
+    return l_it->second;
+    
+}
+
+const std::string& symbol_table::identifier(
+    const std::size_t& a_variable
+)
+{
+    entries_type& l_entries = entries();
+
+    // Appending to the deque leaves references to its elements valid,
+    // so the reference may be used after the lock is released.
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    return l_entries.m_identifiers.at(a_variable);
+    
+}
+
+std::size_t symbol_table::size(
+
+)
+{
+    entries_type& l_entries = entries();
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    return l_entries.m_identifiers.size();
+    
+}
+
+symbol_table::entries_type& symbol_table::entries(
+
+)
+{
+    // Intentionally never destroyed, so that operands which outlive
+    // static destruction may still render themselves.
+    static entries_type* l_entries = new entries_type();
+    return *l_entries;
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <assert.h>
+
+#include "include/calculator.hpp"
+
+using namespace ba_calculator;
+
+std::shared_ptr<operand> unique_table::intern(
+    operand* a_operand
+)
+{
+    if (a_operand == nullptr)
+        return std::shared_ptr<operand>();
+
+    entries_type& l_entries = entries();
+
+    std::shared_ptr<operand> l_canonical;
+
+    // Colliding instances pinned while comparing. Should one of them hold the
+    // last reference, it must be destroyed after the lock is released.
+    std::vector<std::shared_ptr<operand>> l_colliding;
+
+    {
+        std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+        auto l_range = l_entries.m_operands.equal_range(a_operand->m_hash);
+
+        for (auto l_it = l_range.first; l_it != l_range.second; std::advance(l_it, 1))
+        {
+            // Pin the instance before touching it. An expired entry may belong
+            // to an operand which another thread is destroying right now, and
+            // which only erases its entry once its destructor runs.
+            std::shared_ptr<operand> l_instance = l_it->second.m_instance.lock();
+
+            if (!l_instance)
+                continue;
+
+            // Either the operand is already the canonical instance, or an
+            // equal canonical instance is alive.
+            if (l_instance.get() == a_operand || l_instance->shallow_equals(*a_operand))
+            {
+                l_canonical = std::move(l_instance);
+                break;
+            }
+
+            l_colliding.push_back(std::move(l_instance));
+            
+        }
+
+        if (!l_canonical)
+        {
+            // Place the reference-count block alongside the operand itself.
+            l_canonical = std::shared_ptr<operand>(
+                a_operand,
+                std::default_delete<operand>(),
+                arena_allocator<operand>()
+            );
+
+            a_operand->m_is_interned = true;
+
+            l_entries.m_operands.insert({a_operand->m_hash, {a_operand, l_canonical}});
+
+            return l_canonical;
+        }
+    }
+
+    // The canonical instance wins; release the duplicate. This must happen without
+    // holding the lock, as its destruction may erase other entries from the table.
+    if (l_canonical.get() != a_operand)
+        delete a_operand;
+
+    return l_canonical;
+    
+}
+
+void unique_table::erase(
+    const operand* a_operand
+)
+{
+    entries_type& l_entries = entries();
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    auto l_range = l_entries.m_operands.equal_range(a_operand->m_hash);
+
+    for (auto l_it = l_range.first; l_it != l_range.second; std::advance(l_it, 1))
+    {
+        if (l_it->second.m_operand != a_operand)
+            continue;
+
+        l_entries.m_operands.erase(l_it);
+
+        return;
+        
+    }
+    
+}
+
+std::size_t unique_table::size(
+
+)
+{
+    entries_type& l_entries = entries();
+
+    std::lock_guard<std::mutex> l_lock(l_entries.m_mutex);
+
+    return l_entries.m_operands.size();
+    
+}
+
+unique_table::entries_type& unique_table::entries(
+
+)
+{
+    // Intentionally never destroyed, so that operands which outlive
+    // static destruction may still unregister themselves safely.
+    static entries_type* l_entries = new entries_type();
+    return *l_entries;
+}
@@ -18,21 +18,31 @@ unresolved::~unresolved(
 unresolved::unresolved(
     const std::string& a_identifier
 ) :
-    operand(UNRESOLVED),
-    m_identifier(a_identifier)
+    unresolved(symbol_table::intern(a_identifier))
 {
 
 }
 
+unresolved::unresolved(
+    const std::size_t& a_variable
+) :
+    operand(UNRESOLVED),
+    m_variable(a_variable)
+{
+    m_hash = combine_hash(m_hash, std::hash<std::size_t>()(a_variable));
+    m_support.push_back(a_variable);
+}
+
 operand::ptr unresolved::substitute(
-    const std::string& a_identifier,
-    const ptr& a_operand
+    const substitutions& a_substitutions
 ) const
 {
-    if (a_identifier == m_identifier)
-        return a_operand;
+    auto l_it = a_substitutions.find(m_variable);
+
+    if (l_it != a_substitutions.end())
+        return l_it->second;
     
-    return ptr((operand*)this);
+    return self();
 
 }
 
@@ -40,7 +50,7 @@ std::string unresolved::to_string(
 
 ) const
 {
-    return m_identifier;
+    return symbol_table::identifier(m_variable);
 }
 
 bool unresolved::operator<(
@@ -54,6 +64,19 @@ bool unresolved::operator<(
 
     const unresolved& l_unresolved = (const unresolved&)a_operand;
 
-    return m_identifier < l_unresolved.m_identifier;
+    return m_variable < l_unresolved.m_variable;
+    
+}
+
+bool unresolved::shallow_equals(
+    const operand& a_operand
+) const
+{
+    if (a_operand.m_operand_type != m_operand_type)
+        return false;
+
+    const unresolved& l_unresolved = (const unresolved&)a_operand;
+
+    return m_variable == l_unresolved.m_variable;
     
 }